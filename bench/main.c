@@ -0,0 +1,327 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Hexadoku.h"
+#include "InputFunctions.h"
+#include "Options.h"
+#include "PuzzleSolver.h"
+#include "SearchStats.h"
+
+#define DEFAULT_RUNS 10
+#define MAX_CONFIGS  8
+
+typedef enum BenchFormat { FORMAT_CSV, FORMAT_JSON } BenchFormat;
+
+// A named solver setup to measure. All of them are run by default.
+typedef struct BenchConfig {
+    const char* name;
+    Engine      engine;
+    bool        propagate;
+    size_t      table_megabytes;
+} BenchConfig;
+
+static const BenchConfig BENCH_CONFIGS[] = {
+    {"dlx", ENGINE_DLX, true, 0},
+    {"dlx-nosingles", ENGINE_DLX, false, 0},
+    {"dlx-table", ENGINE_DLX, true, 16},
+    {"bitset", ENGINE_BITSET, true, 0},
+    {"bitcover", ENGINE_BITCOVER, true, 0},
+    {"lockstep", ENGINE_LOCKSTEP, true, 0},
+};
+#define BENCH_CONFIG_COUNT (int)(sizeof(BENCH_CONFIGS) / sizeof(*BENCH_CONFIGS))
+
+typedef struct BenchPuzzle {
+    char      name[128];  // file path and record index
+    uint8_t** clues;
+} BenchPuzzle;
+
+typedef struct BenchCorpus {
+    BenchPuzzle* puzzles;
+    int          size;
+    int          capacity;
+} BenchCorpus;
+
+// Timing and work counters of one puzzle (or a whole corpus) under one engine.
+typedef struct BenchResult {
+    const char* config;
+    const char* puzzle;
+    int         solutions;
+    uint64_t    median_ns;
+    uint64_t    p99_ns;
+    SearchStats stats;
+} BenchResult;
+
+static int compareUint64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void addPuzzle(BenchCorpus* corpus, const char* path, int index,
+                      uint8_t** clues) {
+    if (corpus->size == corpus->capacity) {
+        corpus->capacity = corpus->capacity ? 2 * corpus->capacity : 64;
+        corpus->puzzles  = (BenchPuzzle*)realloc(
+            corpus->puzzles, corpus->capacity * sizeof(BenchPuzzle));
+    }
+    BenchPuzzle* puzzle = &corpus->puzzles[corpus->size++];
+    snprintf(puzzle->name, sizeof(puzzle->name), "%s#%d", path, index);
+    puzzle->clues = clues;
+}
+
+// Load every valid record of the file, reporting and skipping the rest.
+static bool loadCorpus(BenchCorpus* corpus, const char* path,
+                       PuzzleFormat input_format) {
+    FILE* input = fopen(path, "r");
+    if (input == NULL) {
+        perror(path);
+        return false;
+    }
+
+    PuzzleReader* reader   = createPuzzleReader(input);
+    uint8_t**     hexadoku = createHexadoku();
+    ReadStatus    status;
+    for (int index = 0;
+         (status = readPuzzleRecord(reader, input_format, hexadoku, true)) !=
+         READ_EOF;
+         index++) {
+        if (status != READ_OK || !isHexadokuValid(hexadoku)) {
+            fprintf(stderr, "%s#%d: invalid puzzle, skipped\n", path, index);
+            continue;
+        }
+        addPuzzle(corpus, path, index, hexadoku);
+        hexadoku = createHexadoku();
+    }
+    freeHexadoku(hexadoku);
+    freePuzzleReader(reader);
+    fclose(input);
+    return true;
+}
+
+static void copyHexadoku(uint8_t** destination, uint8_t** source) {
+    memcpy(destination[0], source[0], SUDOKU_SIZE * SUDOKU_SIZE);
+}
+
+static void addStats(SearchStats* total, const SearchStats* stats) {
+    total->nodes += stats->nodes;
+    total->covers += stats->covers;
+    total->uncovers += stats->uncovers;
+    total->placements += stats->placements;
+    total->backtracks += stats->backtracks;
+    total->link_updates += stats->link_updates;
+    total->table_hits += stats->table_hits;
+    total->splits += stats->splits;
+    total->first_solution_ns += stats->first_solution_ns;
+}
+
+// Forget the subtrees of earlier solves, which would answer a repeated puzzle
+// at the root.
+static void clearTable(PuzzleSolver* solver) {
+    if (solver->context.table != NULL)
+        clearTranspositionTable(solver->context.table);
+}
+
+// Solve the puzzle once untimed to warm the caches, then `runs` times timed.
+static void benchPuzzle(PuzzleSolver* solver, const BenchPuzzle* puzzle,
+                        uint8_t** work, uint64_t* times, int runs,
+                        BenchResult* result) {
+    copyHexadoku(work, puzzle->clues);
+    clearTable(solver);
+    result->solutions = solvePuzzle(solver, work);
+    result->stats     = solver->stats;
+
+    for (int run = 0; run < runs; run++) {
+        copyHexadoku(work, puzzle->clues);
+        clearTable(solver);
+        uint64_t start = statsNowNs();
+        solvePuzzle(solver, work);
+        times[run] = statsNowNs() - start;
+    }
+    qsort(times, runs, sizeof(*times), compareUint64);
+    result->median_ns = times[runs / 2];
+    result->p99_ns    = times[(runs * 99 + 99) / 100 - 1];
+}
+
+static void printHeader(BenchFormat format) {
+    if (format == FORMAT_CSV)
+        printf("config,puzzle,solutions,median_ns,p99_ns,nodes,covers,uncovers,"
+               "placements,backtracks,link_updates,table_hits,splits,"
+               "first_solution_ns\n");
+    else
+        printf("[\n");
+}
+
+static void printResult(BenchFormat format, const BenchResult* result,
+                        bool last) {
+    const SearchStats* stats = &result->stats;
+    if (format == FORMAT_CSV) {
+        printf("%s,%s,%d,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,"
+               "%llu\n",
+               result->config, result->puzzle, result->solutions,
+               (unsigned long long)result->median_ns,
+               (unsigned long long)result->p99_ns,
+               (unsigned long long)stats->nodes,
+               (unsigned long long)stats->covers,
+               (unsigned long long)stats->uncovers,
+               (unsigned long long)stats->placements,
+               (unsigned long long)stats->backtracks,
+               (unsigned long long)stats->link_updates,
+               (unsigned long long)stats->table_hits,
+               (unsigned long long)stats->splits,
+               (unsigned long long)stats->first_solution_ns);
+        return;
+    }
+    printf("  {\"config\": \"%s\", \"puzzle\": \"%s\", \"solutions\": %d, "
+           "\"median_ns\": %llu, \"p99_ns\": %llu, \"nodes\": %llu, "
+           "\"covers\": %llu, \"uncovers\": %llu, \"placements\": %llu, "
+           "\"backtracks\": %llu, \"link_updates\": %llu, "
+           "\"table_hits\": %llu, \"splits\": %llu, "
+           "\"first_solution_ns\": %llu}%s\n",
+           result->config, result->puzzle, result->solutions,
+           (unsigned long long)result->median_ns,
+           (unsigned long long)result->p99_ns,
+           (unsigned long long)stats->nodes, (unsigned long long)stats->covers,
+           (unsigned long long)stats->uncovers,
+           (unsigned long long)stats->placements,
+           (unsigned long long)stats->backtracks,
+           (unsigned long long)stats->link_updates,
+           (unsigned long long)stats->table_hits,
+           (unsigned long long)stats->splits,
+           (unsigned long long)stats->first_solution_ns, last ? "" : ",");
+}
+
+static const BenchConfig* findConfig(const char* name) {
+    for (int i = 0; i < BENCH_CONFIG_COUNT; i++)
+        if (strcmp(name, BENCH_CONFIGS[i].name) == 0) return &BENCH_CONFIGS[i];
+    return NULL;
+}
+
+static void printBenchUsage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [-r runs] [-f csv|json] [-e config]... [-k limit] [-l] "
+            "[-v] file...\n"
+            "  -r  timed runs per puzzle and engine (default %d)\n"
+            "  -f  output format (default csv)\n"
+            "  -e  configuration to measure, may be repeated (default all):\n"
+            "      dlx, dlx-nosingles (DLX without propagation), dlx-table\n"
+            "      (DLX with a 16 MB transposition table), bitset, bitcover,\n"
+            "      lockstep (one puzzle at a time)\n"
+            "  -k  stop each search after limit solutions (default 0, all)\n"
+            "  -l  the files hold one puzzle per line, as read by -f line\n"
+            "  -v  print the search depth histogram of each puzzle to stderr\n"
+            "Prints median and p99 wall time and search counters per puzzle,\n"
+            "then one \"TOTAL\" row per configuration.\n",
+            program, DEFAULT_RUNS);
+}
+
+int main(int argc, char** argv) {
+    int                runs           = DEFAULT_RUNS;
+    BenchFormat        format         = FORMAT_CSV;
+    const BenchConfig* configs[MAX_CONFIGS];
+    int                config_count   = 0;
+    bool               verbose        = false;
+    int                solution_limit = 0;
+    PuzzleFormat       input_format   = FORMAT_PROGTEST;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "r:f:e:k:lvh")) != -1) {
+        switch (opt) {
+            case 'r':
+                runs = atoi(optarg);
+                if (runs < 1) {
+                    printBenchUsage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'f':
+                if (strcmp(optarg, "csv") == 0)
+                    format = FORMAT_CSV;
+                else if (strcmp(optarg, "json") == 0)
+                    format = FORMAT_JSON;
+                else {
+                    printBenchUsage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'e':
+                if (config_count == MAX_CONFIGS ||
+                    (configs[config_count++] = findConfig(optarg)) == NULL) {
+                    printBenchUsage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'k':
+                solution_limit = atoi(optarg);
+                if (solution_limit < 0) {
+                    printBenchUsage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'l':
+                input_format = FORMAT_LINE;
+                break;
+            case 'v':
+                verbose = true;
+                break;
+            default:
+                printBenchUsage(argv[0]);
+                return 2;
+        }
+    }
+    if (optind == argc) {
+        printBenchUsage(argv[0]);
+        return 2;
+    }
+    if (config_count == 0)
+        for (int i = 0; i < BENCH_CONFIG_COUNT; i++)
+            configs[config_count++] = &BENCH_CONFIGS[i];
+
+    BenchCorpus corpus = {NULL, 0, 0};
+    for (int i = optind; i < argc; i++)
+        if (!loadCorpus(&corpus, argv[i], input_format)) return 1;
+
+    uint8_t** work  = createHexadoku();
+    uint64_t* times = (uint64_t*)malloc(runs * sizeof(uint64_t));
+
+    printHeader(format);
+    for (int c = 0; c < config_count; c++) {
+        Options options;
+        defaultOptions(&options);
+        options.engine          = configs[c]->engine;
+        options.propagate       = configs[c]->propagate;
+        options.table_megabytes = configs[c]->table_megabytes;
+        options.solution_limit  = solution_limit;
+
+        PuzzleSolver solver;
+        initPuzzleSolver(&solver, &options);
+
+        BenchResult total = {configs[c]->name, "TOTAL", 0, 0, 0, {0}};
+        for (int p = 0; p < corpus.size; p++) {
+            BenchResult result = {configs[c]->name, corpus.puzzles[p].name};
+            benchPuzzle(&solver, &corpus.puzzles[p], work, times, runs,
+                        &result);
+            printResult(format, &result, false);
+            if (verbose) {
+                fprintf(stderr, "%s %s\n", result.config, result.puzzle);
+                printSearchStats(stderr, &result.stats);
+            }
+
+            total.solutions += result.solutions;
+            total.median_ns += result.median_ns;
+            total.p99_ns += result.p99_ns;
+            addStats(&total.stats, &result.stats);
+        }
+        printResult(format, &total, c == config_count - 1);
+        freePuzzleSolver(&solver);
+    }
+    if (format == FORMAT_JSON) printf("]\n");
+
+    for (int p = 0; p < corpus.size; p++) freeHexadoku(corpus.puzzles[p].clues);
+    free(corpus.puzzles);
+    free(times);
+    freeHexadoku(work);
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "Coords.h"
+
+#if BOX_SIZE == 4
+#include "coords16.inc"
+
+// Every one of the table, in the same order.
+static bool matchesReference(void) {
+    for (int i = 0; i < COORDS_COUNT; i++) {
+        int row = i / CONSTRAINTS;
+        int constraints[CONSTRAINTS];
+        rowConstraints(row, constraints);
+        if (REFERENCE_COORDS[i][0] != row) {
+            printf("Coordinate %d: row %d instead of %d\n", i, row,
+                   REFERENCE_COORDS[i][0]);
+            return false;
+        }
+        if (REFERENCE_COORDS[i][1] != constraints[i % CONSTRAINTS]) {
+            printf("Row %d: column %d instead of %d\n", row,
+                   constraints[i % CONSTRAINTS], REFERENCE_COORDS[i][1]);
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+// Each constraint is satisfied by exactly one digit of each of SUDOKU_SIZE
+// cells, and a row has one constraint of each kind.
+static bool isExactCover(void) {
+    static int size[MESH_WIDTH];
+    const int  cells = SUDOKU_SIZE * SUDOKU_SIZE;
+    for (int row = 0; row < COORDS_COUNT / CONSTRAINTS; row++) {
+        int constraints[CONSTRAINTS];
+        rowConstraints(row, constraints);
+        for (int i = 0; i < CONSTRAINTS; i++) {
+            if (constraints[i] / cells != i) {
+                printf("Row %d: column %d is not of kind %d\n", row,
+                       constraints[i], i);
+                return false;
+            }
+            size[constraints[i]]++;
+        }
+    }
+    for (int constraint = 0; constraint < MESH_WIDTH; constraint++) {
+        if (size[constraint] != SUDOKU_SIZE) {
+            printf("Column %d has %d rows\n", constraint, size[constraint]);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(void) {
+    bool valid = isExactCover();
+#if BOX_SIZE == 4
+    valid = valid && matchesReference();
+#endif
+    printf("Exact cover rows of the %dx%d grid: %s\n", SUDOKU_SIZE,
+           SUDOKU_SIZE, valid ? "OK" : "FAILED");
+    return valid ? 0 : 1;
+}
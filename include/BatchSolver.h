@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdio.h>
+
+#include "Options.h"
+
+// Number of puzzles read ahead of the oldest one whose result is not printed.
+#define BATCH_QUEUE_SIZE 1024
+
+/// @brief Solve every Progtest record in the input stream and print one result
+/// per record, in input order.
+///
+/// The calling thread reads records into a bounded ring of puzzles while the
+/// worker threads claim them one at a time, so reading, solving and printing
+/// overlap and no worker waits for the others. Each worker owns a private
+/// DLX mesh and solver context, and prints the results that have become next
+/// in input order when it finishes a puzzle.
+/// With an interleave width above 1, a DLX worker keeps that many searches
+/// of different puzzles going and lets them take one step each in turn.
+///
+/// @param input The stream to read puzzles from.
+/// @param options Number of worker threads, engine and interleave width.
+/// @return Process exit code.
+int solveBatch(FILE* input, const Options* options);
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "MonkeyFistMesh.h"
+#include "SearchStats.h"
+
+// 64-bit words of a set with one bit per exact cover row. Bits past the last
+// row are in no column, so they never take part in the search.
+#define ROW_WORDS ((MESH_ROWS + 63) / 64)
+// Size of a covered column, larger than any open one.
+#define COVERED_COLUMN UINT8_MAX
+
+_Static_assert(MAX_COLUMN_SIZE < COVERED_COLUMN,
+               "column sizes collide with the covered mark");
+
+/// @brief Whole search state of the bit-parallel exact cover engine, copied on
+/// every branch into the state of the next level.
+///
+/// Row cell * SUDOKU_SIZE + digit - 1 places the digit into the cell, so the
+/// live rows of a cell are one SUDOKU_SIZE-bit slice of the set.
+typedef struct BitCoverState {
+    uint64_t live[ROW_WORDS];          // rows that can still be selected
+    uint8_t  column_sizes[MESH_WIDTH];  // live rows per open column
+    uint8_t  cells[SUDOKU_SIZE * SUDOKU_SIZE];  // 0 for an empty cell
+} BitCoverState;
+
+/// @brief Count the solutions of a valid hexadoku with Algorithm X over row
+/// bitsets.
+///
+/// Every column of the exact cover matrix is a precomputed mask of its rows.
+/// Selecting a row clears the masks of its four columns from the live set with
+/// a word-wise AND-NOT and decrements the sizes of the columns of the rows that
+/// dropped out. Grids above 36x36 have no column masks and clear the rows of
+/// the four columns one by one. The search branches on the smallest open
+/// column, selecting columns with a single row in place and copying the state
+/// only when there is a real choice.
+///
+/// @param hexadoku The puzzle, receives the first solution found.
+/// @param solution_limit Stop after this many solutions, 0 to count all.
+/// @param stats Receives the work done, see SearchStats.
+/// @return The number of solutions, at most solution_limit.
+int searchSolutionsBitCover(uint8_t** hexadoku, int solution_limit,
+                            SearchStats* stats);
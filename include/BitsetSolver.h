@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Constants.h"
+#include "SearchStats.h"
+
+// One bit per digit, bit d - 1 standing for digit d, in the narrowest type
+// that holds them.
+#if SUDOKU_SIZE <= 16
+typedef uint16_t DigitMask;
+#elif SUDOKU_SIZE <= 32
+typedef uint32_t DigitMask;
+#else
+typedef uint64_t DigitMask;
+#endif
+
+#define DIGIT_BIT(digit) ((DigitMask)1 << ((digit) - 1))
+#define FULL_DIGIT_MASK                      \
+    ((DigitMask)((DigitMask)~(DigitMask)0 >> \
+                 (8 * sizeof(DigitMask) - SUDOKU_SIZE)))
+
+/// @brief The digit of the lowest bit of a non-empty mask.
+static inline int lowestDigit(DigitMask mask) {
+    return __builtin_ctzll(mask) + 1;
+}
+
+/// @brief Row, column and box of a cell, numbered row by row.
+static inline int rowOfCell(int cell) { return cell / SUDOKU_SIZE; }
+
+static inline int columnOfCell(int cell) { return cell % SUDOKU_SIZE; }
+
+static inline int boxOfCell(int cell) {
+    return rowOfCell(cell) / BOX_SIZE * BOX_SIZE +
+           columnOfCell(cell) / BOX_SIZE;
+}
+
+/// @brief Cell at position i of unit u: the first SUDOKU_SIZE units are the
+/// rows, then the columns and the boxes.
+static inline int unitCell(int unit, int i) {
+    int index = unit % SUDOKU_SIZE;
+    switch (unit / SUDOKU_SIZE) {
+        case 0:
+            return index * SUDOKU_SIZE + i;
+        case 1:
+            return i * SUDOKU_SIZE + index;
+        default:
+            return (index / BOX_SIZE * BOX_SIZE + i / BOX_SIZE) * SUDOKU_SIZE +
+                   index % BOX_SIZE * BOX_SIZE + i % BOX_SIZE;
+    }
+}
+
+/// @brief Whole search state of the bitset engine, copied on every branch into
+/// the grid of the next level.
+typedef struct BitsetGrid {
+    uint8_t   cells[SUDOKU_SIZE * SUDOKU_SIZE];  // 0 for an empty cell
+    DigitMask rows[SUDOKU_SIZE];                // digits placed in each row
+    DigitMask columns[SUDOKU_SIZE];             // ... in each column
+    DigitMask boxes[SUDOKU_SIZE];               // ... in each box
+    int       empty_cells;
+} BitsetGrid;
+
+/// @brief Computes the candidates of every cell of the grid at once.
+/// Implementations live in CandidateKernel.h.
+/// @param grid The grid to inspect.
+/// @param candidates Receives SUDOKU_SIZE * SUDOKU_SIZE masks, 0 for filled
+/// cells.
+/// @param min_count Receives the number of candidates of the returned cell.
+/// @return The empty cell with the fewest candidates (the lowest index among
+/// equals), or -1 if the grid is full.
+typedef int (*CandidateKernel)(const BitsetGrid* grid, DigitMask* candidates,
+                               int* min_count);
+
+/// @brief Count the solutions of a valid hexadoku with the bitset engine.
+///
+/// Candidates of a cell are the digits missing from its row, column and box
+/// masks. Before every branch, naked singles (cells with one candidate) and
+/// hidden singles (digits with one possible cell in a row, column or box) are
+/// placed until nothing changes, then the search branches on the empty cell
+/// with the fewest candidates.
+///
+/// @param hexadoku The puzzle, receives the first solution found.
+/// @param solution_limit Stop after this many solutions, 0 to count all.
+/// @param stats Receives the work done, see SearchStats.
+/// @return The number of solutions, at most solution_limit.
+int  searchSolutionsBitset(uint8_t** hexadoku, int solution_limit,
+                           SearchStats* stats);
+
+/// @brief Place a digit into an empty cell and update the unit masks.
+void placeDigit(BitsetGrid* grid, int cell, int digit);
+
+/// @brief Digits that can still be placed into the cell.
+DigitMask cellCandidates(const BitsetGrid* grid, int cell);
+
+/// @brief Place naked and hidden singles until none are left.
+/// @param grid The grid to fill.
+/// @param kernel Candidate kernel from selectCandidateKernel.
+/// @param candidates Room for the SUDOKU_SIZE * SUDOKU_SIZE candidate masks,
+/// overwritten.
+/// @param min_cell Receives the empty cell with the fewest candidates, -1 if
+/// the grid is full.
+/// @return false if the grid turned out to be unsolvable.
+bool propagateSingles(BitsetGrid* grid, CandidateKernel kernel,
+                      DigitMask* candidates, int* min_cell);
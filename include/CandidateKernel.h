@@ -0,0 +1,23 @@
+#pragma once
+
+#include "BitsetSolver.h"
+
+// x86 builds carry vector kernels for every engine, each picked at runtime by
+// candidateKernelName.
+#if defined(__x86_64__) || defined(__i386__)
+#define HAS_X86_KERNELS
+#endif
+
+/// @brief Portable implementation, one cell at a time.
+int             computeCandidatesScalar(const BitsetGrid* grid,
+                                        DigitMask* candidates, int* min_count);
+
+/// @brief Pick the widest implementation the CPU supports (AVX2, SSE2 or
+/// scalar), detected with cpuid. The HEXADOKU_SIMD environment variable set to
+/// "avx2", "sse2" or "scalar" restricts the choice, e.g. for benchmarking.
+CandidateKernel selectCandidateKernel(void);
+
+/// @brief Name of the widest instruction set the CPU supports and
+/// HEXADOKU_SIMD allows, which the kernels of every engine are picked by. The
+/// candidate kernels of grids other than 16x16 are always scalar.
+const char*     candidateKernelName(void);
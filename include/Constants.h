@@ -3,8 +3,16 @@
 #include <stddef.h>
 #include <stdio.h>
 
-#define SUDOKU_SIZE 16
+// Order of the grid: boxes are BOX_SIZE x BOX_SIZE cells and the grid has
+// SUDOKU_SIZE rows, columns and digits. Every table and loop bound follows
+// from it at compile time, build with e.g. `make BOX_SIZE=5` for 25x25 grids.
+#ifndef BOX_SIZE
 #define BOX_SIZE 4
+#endif
+#define SUDOKU_SIZE (BOX_SIZE * BOX_SIZE)
+
+_Static_assert(BOX_SIZE >= 2 && BOX_SIZE <= 8,
+               "grids from 4x4 to 64x64 are supported");
 
 // 1. Each cell must contain a number.
 // 2. Each row must contain each number exactly once.
@@ -13,6 +21,10 @@
 #define CONSTRAINTS 4
 #define MESH_WIDTH (SUDOKU_SIZE * SUDOKU_SIZE * CONSTRAINTS)
 
+// Levels of the bitset and bit cover searches: each level below the root fills
+// at least one cell.
+#define SEARCH_LEVELS (SUDOKU_SIZE * SUDOKU_SIZE + 1)
+
 #ifdef DEBUG
 #define DEBUG_PRINTF(...)    \
     do {                     \
@@ -24,5 +36,9 @@
     } while (false)
 #endif
 
-extern const size_t LINE_WIDTH;
-extern const size_t LINE_HEIGHT;
+// Characters of every line and lines of a grid in the Progtest format.
+#define LINE_WIDTH (4 * SUDOKU_SIZE + 1)
+#define LINE_HEIGHT (2 * SUDOKU_SIZE + 1)
+
+// Letters of the digits 1 to SUDOKU_SIZE in the Progtest format, a for 1.
+extern const char DIGIT_SYMBOLS[];
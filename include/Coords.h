@@ -1,7 +1,31 @@
 #pragma once
 
-#define COORDS_ARRAY_SIZE 16384
+#include "Constants.h"
 
-// Pre-generated array, containing coordinates of ones in the exact cover
-// matrix.
-extern const int COORDS_ARRAY[COORDS_ARRAY_SIZE][2];
+// Ones in the exact cover matrix of the empty grid, CONSTRAINTS per row.
+#define COORDS_COUNT (SUDOKU_SIZE * SUDOKU_SIZE * SUDOKU_SIZE * CONSTRAINTS)
+
+_Static_assert(CONSTRAINTS == 4, "a row has a cell, row, column and box one");
+
+/// @brief Columns of the ones of an exact cover row of the empty grid.
+///
+/// Row cell * SUDOKU_SIZE + digit - 1 places the digit into the cell. It
+/// satisfies the constraint of its cell and those of the digit in its row,
+/// column and box, each kind a block of SUDOKU_SIZE^2 columns. The divisions
+/// are by constants: shifts for 16x16, multiplications for the other sizes.
+///
+/// @param row Index of the row, below SUDOKU_SIZE^3.
+/// @param constraints Receives the columns, in the order cell, row, column,
+/// box.
+static inline void rowConstraints(int row, int constraints[CONSTRAINTS]) {
+    const unsigned cells  = SUDOKU_SIZE * SUDOKU_SIZE;
+    unsigned       cell   = (unsigned)row / SUDOKU_SIZE;
+    unsigned       digit  = (unsigned)row % SUDOKU_SIZE;
+    unsigned       line   = cell / SUDOKU_SIZE;
+    unsigned       column = cell % SUDOKU_SIZE;
+    unsigned       box    = line / BOX_SIZE * BOX_SIZE + column / BOX_SIZE;
+    constraints[0] = cell;
+    constraints[1] = cells + line * SUDOKU_SIZE + digit;
+    constraints[2] = 2 * cells + column * SUDOKU_SIZE + digit;
+    constraints[3] = 3 * cells + box * SUDOKU_SIZE + digit;
+}
@@ -9,17 +9,47 @@
 #include "stdio.h"
 #include "stdlib.h"
 
-/// @brief Checks if the given 16x16 hexadoku puzzle is valid.
+/// @brief Allocates a zeroed SUDOKU_SIZE x SUDOKU_SIZE hexadoku. Rows point
+/// into a single contiguous block, so the grid can be reused across puzzles.
+uint8_t** createHexadoku(void);
+
+/// @brief Frees a hexadoku allocated with createHexadoku.
+void      freeHexadoku(uint8_t** hexadoku);
+
+/// @brief Checks if the given hexadoku puzzle is valid.
 ///
 /// This function checks that each row, column and box of the sudoku puzzle
 /// contains at most one unique number. 0 represents an empty cell in the
 /// puzzle.
 ///
-/// @param hexadoku A pointer to a 16x16 array representing the hexadoku puzzle.
+/// @param hexadoku A pointer to a SUDOKU_SIZE x SUDOKU_SIZE array representing
+/// the hexadoku puzzle.
 /// @return true if the hexadoku puzzle is valid, false otherwise.
 bool isHexadokuValid(uint8_t** hexadoku);
 
-/// @brief Prints the given 16x16 hexadoku puzzle to the standard output.
-/// @param hexadoku A pointer to a 16x16 array representing the hexadoku puzzle
-/// to be printed.
+/// @brief Prints the given hexadoku puzzle to the standard output.
+/// @param hexadoku A pointer to a SUDOKU_SIZE x SUDOKU_SIZE array representing
+/// the hexadoku puzzle to be printed.
 void printHexadoku(uint8_t** hexadoku);
+
+/// @brief Prints the hexadoku on one line of SUDOKU_SIZE^2 letters, row by
+/// row, with '.' for empty cells.
+void printHexadokuLine(uint8_t** hexadoku);
+
+/// @brief Whether a search has found as many solutions as it was asked for.
+/// @param solution_limit The requested number of solutions, 0 for all.
+static inline bool isSolutionLimitReached(int solution_count,
+                                          int solution_limit) {
+    return solution_limit != 0 && solution_count >= solution_limit;
+}
+
+/// @brief Prints the Progtest verdict for a solved hexadoku: the solution if
+/// it is unique, the number of solutions otherwise. A search stopped at its
+/// solution limit prints "Celkem reseni: alespon K" instead of the exact
+/// count, followed by the solution found when K is 1.
+/// @param hexadoku The hexadoku holding the first solution found.
+/// @param solution_count Number of solutions found.
+/// @param solution_limit The limit the search ran with, 0 for none.
+/// @param format Format of the printed solution.
+void printSolveResult(uint8_t** hexadoku, int solution_count,
+                      int solution_limit, PuzzleFormat format);
@@ -2,27 +2,76 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 
 #include "Constants.h"
 
-/// @brief Read a hexadoku from the standard input in Progtest format (pretty).
-/// @return A pointer to a SUDOKU_SIZE x SUDOKU_SIZE array representing the
-/// puzzle.
-uint8_t** readProgtest(void);
+typedef enum ReadStatus { READ_OK, READ_INVALID, READ_EOF } ReadStatus;
+
+typedef enum PuzzleFormat {
+    FORMAT_PROGTEST,  // bordered grid of 2 * SUDOKU_SIZE + 1 lines
+    FORMAT_LINE,      // one line of SUDOKU_SIZE^2 cells, '.' or '0' if blank
+} PuzzleFormat;
+
+/// @brief Buffered reader of puzzle records from a stream.
+///
+/// The stream is read in large blocks into one buffer that is reused for the
+/// whole stream, and every line is decoded where it lies in the buffer, so
+/// nothing is allocated or copied per line. Lines are checked against
+/// templates of the expected line built once per reader, eight bytes at a
+/// time, and letters are decoded through a table of all byte values. Records
+/// are decoded straight into the flat cell block of the hexadoku.
+typedef struct PuzzleReader {
+    FILE*   stream;
+    char*   buffer;
+    size_t  capacity;
+    size_t  start;                    // first byte not consumed yet
+    size_t  end;                      // end of the bytes read so far
+    bool    eof;                      // the stream has no more bytes
+    bool    interactive;              // a terminal, read line by line
+    char    solid[LINE_WIDTH];        // "+---+---+ ... +"
+    char    dashed[LINE_WIDTH];       // "+   +   + ... +"
+    char    letters[LINE_WIDTH];      // "|   |   | ... |"
+    uint8_t letter_mask[LINE_WIDTH];  // 0 where the letters are
+    // digit of every byte value, 0 for ' ' and 0xFF if not a digit
+    uint8_t digits[256];
+    // same for the line format, where '.' and '0' are blank and up to 26x26
+    // the digits 1 to 9 and capital letters are accepted too
+    uint8_t line_digits[256];
+} PuzzleReader;
 
-/// @brief Helper function for readProgtest.
-bool      isDelimiterStringValid(char* string, bool is_dashed);
+/// @brief Create a reader of the given stream. The stream is not closed by
+/// freePuzzleReader.
+PuzzleReader* createPuzzleReader(FILE* stream);
 
-/// @brief Helper function for readProgtest.
-bool      isLetterValid(char a);
+/// @brief Free a reader allocated with createPuzzleReader.
+void            freePuzzleReader(PuzzleReader* reader);
+
+/// @brief Read a hexadoku from the standard input, which must hold nothing
+/// else.
+/// @param format Format of the puzzle.
+/// @return A pointer to a SUDOKU_SIZE x SUDOKU_SIZE array representing the
+/// puzzle, NULL if the input is malformed.
+uint8_t** readPuzzle(PuzzleFormat format);
 
-/// @brief Helper function for readProgtest. Converts a row from pretty-printed
-/// sudoku to an array of uint8_t with values [0-SUDOKU_SIZE).
-uint8_t*  strToUint8t(char* string);
+/// @brief Read one puzzle from a stream of records in the given format.
+/// @param reader The reader of the stream.
+/// @param format Format of the records.
+/// @param hexadoku Preallocated SUDOKU_SIZE x SUDOKU_SIZE array to fill, its
+/// rows must be one block as allocated by createHexadoku.
+/// @param skip_blank_lines Whether empty lines before the record are ignored.
+/// @return READ_EOF if the stream ended before the record, READ_INVALID if the
+/// record is malformed (it is still consumed whole), READ_OK otherwise.
+ReadStatus readPuzzleRecord(PuzzleReader* reader, PuzzleFormat format,
+                            uint8_t** hexadoku, bool skip_blank_lines);
 
-/// @brief Removes trailing spaces.
-void      stripString(char* string);
+/// @brief Read one Progtest formatted hexadoku, see readPuzzleRecord.
+ReadStatus readProgtestRecord(PuzzleReader* reader, uint8_t** hexadoku,
+                              bool skip_blank_lines);
 
-/// @brief Reads string from stdin using getline, removes trailing newline,
-/// returns '\0' string in case of failure.
-char*     getString(void);
+/// @brief Read one hexadoku written on a single line, see readPuzzleRecord.
+/// The cells follow row by row, as the digit letters of the Progtest format
+/// or, in grids up to 26x26, as 1 to 9 followed by A, B, ... (1-9A-G for
+/// 16x16), with '.' or '0' for a blank.
+ReadStatus readLineRecord(PuzzleReader* reader, uint8_t** hexadoku,
+                          bool skip_blank_lines);
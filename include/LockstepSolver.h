@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "Constants.h"
+#include "SearchStats.h"
+
+// Puzzles propagated together, one per DigitMask lane: for 16x16 grids a whole
+// 256-bit vector per operation with AVX2.
+#define LOCKSTEP_LANES 16
+
+/// @brief Count the solutions of up to LOCKSTEP_LANES valid hexadokus at once.
+///
+/// The puzzles are stored lane by lane: every cell, row, column and box mask
+/// is an array with one entry per puzzle, and each propagation step runs the
+/// same instructions over all lanes. Naked and hidden singles are placed as in
+/// the bitset engine, with every placement checked against the current masks,
+/// until no lane changes. A lane with a contradiction stops counting, a full
+/// lane is solved. Lanes that need to branch continue one by one with the
+/// bitset engine from their propagated grid.
+///
+/// @param puzzles The puzzles, each receives its first solution found.
+/// @param count Number of puzzles, at most LOCKSTEP_LANES.
+/// @param solution_limit Stop after this many solutions, 0 to count all.
+/// @param solution_counts Receives the number of solutions of every puzzle,
+/// at most solution_limit.
+/// @param stats Receives the work done on all puzzles, see SearchStats. The
+/// propagation counts as the root node of every lane.
+void solveLockstep(uint8_t** puzzles[], int count, int solution_limit,
+                   int solution_counts[], SearchStats* stats);
@@ -7,19 +7,131 @@
 #include "Constants.h"
 #include "Coords.h"
 #include "Node.h"
+#include "SearchStats.h"
 
-/// @brief Create a DLX mesh from pre-generated coord array, then fill it with
-/// hints from the given hexadoku.
-/// @param hexadoku A pointer to a SUDOKU_SIZE x SUDOKU_SIZE array.
-/// @return A pointer to the head of the DLX mesh.
-Node* createDLXMesh(uint8_t** hexadoku);
+// Rows of the exact cover matrix, one per cell and digit.
+#define MESH_ROWS (COORDS_COUNT / CONSTRAINTS)
+// Head, column headers, padding and one node per coordinate in the worst case
+// of an empty grid.
+#define MESH_CAPACITY (FIRST_ROW_NODE(MESH_WIDTH) + COORDS_COUNT)
+// Index of the head node. It is not linked to the columns, which are reached
+// through their size buckets, but keeps the column headers at indices from 1.
+#define MESH_HEAD 0
+
+// Every constraint is satisfied by exactly SUDOKU_SIZE rows of the empty grid.
+#define MAX_COLUMN_SIZE SUDOKU_SIZE
+
+// Columns are filed in one bucket per size. The 65 sizes of a 64x64 grid do
+// not fit a 64-bit mask, so there the full columns share the last bucket with
+// those one row short: the search may then branch on a full column while a
+// shorter one exists, which is only a worse guess.
+#if MAX_COLUMN_SIZE < 64
+#define BUCKET_COUNT (MAX_COLUMN_SIZE + 1)
+#define BUCKET_OF(size) (size)
+#else
+#define BUCKET_COUNT 64
+#define BUCKET_OF(size) ((size) < BUCKET_COUNT ? (size) : BUCKET_COUNT - 1)
+#endif
+// Bucket lists share the index space of column headers, the list of bucket b
+// starts at sentinel MESH_WIDTH + 1 + b.
+#define BUCKET_SENTINEL(bucket) (MESH_WIDTH + 1 + (bucket))
+#define BUCKET_LINKS (MESH_WIDTH + 1 + BUCKET_COUNT)
+
+// Row nodes follow the column headers from the next multiple of CONSTRAINTS,
+// so every row is one aligned group of CONSTRAINTS consecutive nodes.
+#define FIRST_ROW_NODE(column_count) \
+    ((1 + (column_count) + CONSTRAINTS - 1) / CONSTRAINTS * CONSTRAINTS)
+
+// Bit b of a bucket mask stands for the columns of bucket b.
+#if BUCKET_COUNT <= 32
+typedef uint32_t BucketMask;
+#else
+typedef uint64_t BucketMask;
+#endif
+#define BUCKET_BIT(bucket) ((BucketMask)1 << (bucket))
+
+_Static_assert(MESH_CAPACITY - 1 <= (NodeIndex)-1,
+               "NodeIndex is too narrow for the mesh");
+_Static_assert(MESH_ROWS - 1 <= (sizeof(RowID) == 2 ? INT16_MAX : INT32_MAX),
+               "RowID is too narrow for the rows");
+_Static_assert((CONSTRAINTS & (CONSTRAINTS - 1)) == 0,
+               "row groups are addressed with a mask");
+_Static_assert(COORDS_COUNT ==
+                   SUDOKU_SIZE * SUDOKU_SIZE * SUDOKU_SIZE * CONSTRAINTS,
+               "every row has exactly CONSTRAINTS nodes");
+
+/// @brief Arena holding a whole DLX mesh: the head, the column headers and
+/// the row nodes, in this order. Only the constraints left open by the hints
+/// get a column and only the rows that can still be chosen get nodes, so the
+/// used part of the arena is compact. The arena is sized for the empty grid,
+/// 17 MB for 64x64, but the pages past the used part are never touched, so
+/// the memory a mesh takes grows with its live rows only.
+///
+/// Uncovered columns are kept in doubly linked lists by their node count, with
+/// a mask of the non-empty lists, so the smallest column is found without
+/// scanning the headers. A mesh without uncovered columns has an empty mask.
+typedef struct Mesh {
+    Node       nodes[MESH_CAPACITY];
+    uint16_t   node_count[MESH_WIDTH + 1];  // indexed by column header
+    NodeIndex  bucket_next[BUCKET_LINKS];
+    NodeIndex  bucket_prev[BUCKET_LINKS];
+    BucketMask bucket_mask;   // bit b is set if bucket b has a column
+    int        column_count;  // headers are 1 to column_count
+    int        open_columns;  // columns not covered
+    int        size;          // number of nodes in use
+    NodeIndex  row_nodes[MESH_ROWS];  // first node of each row, 0 if dropped
+#ifdef SEARCH_STATS
+    SearchStats stats;  // work done since the hints were applied
+#endif
+} Mesh;
+
+/// @brief Create a DLX mesh for the given hexadoku.
+///
+/// The hints are presolved first: every constraint a hint satisfies is
+/// dropped, and so is every row sharing a constraint with a hint (the other
+/// digits of its cell and its digit in the same row, column and box). The mesh
+/// is then built from rowConstraints over the remaining rows and columns
+/// only, so the hints are not part of the search.
+///
+/// @param hexadoku A pointer to a valid SUDOKU_SIZE x SUDOKU_SIZE array.
+/// @param mesh Arena to build the mesh in, e.g. a previous mesh that is no
+/// longer needed. If NULL, a new one is allocated.
+/// @return The arena holding the mesh.
+Mesh* createDLXMesh(uint8_t** hexadoku, Mesh* mesh);
+
+/// @brief Rows of a column of the exact cover matrix of the empty grid, in
+/// ascending order.
+typedef RowID ColumnRows[MAX_COLUMN_SIZE];
+
+/// @brief The rows of every column of the empty grid, indexed by constraint.
+/// Built on the first call, the table is shared by all threads and engines.
+const ColumnRows* emptyGridColumnRows(void);
+
+/// @brief Index of the first node of an exact cover row in a mesh created by
+/// createDLXMesh, 0 if the presolve dropped the row. Rows keep their place,
+/// whatever has been covered since.
+NodeIndex meshRowNode(const Mesh* mesh, int row_index);
+
+/// @brief The node `offset` places right of a row node, wrapping around its
+/// row. Nodes of a row are an aligned group of CONSTRAINTS indices, so
+/// rowNeighbor(node, CONSTRAINTS - 1) is its left neighbor.
+static inline NodeIndex rowNeighbor(NodeIndex node, int offset) {
+    return (node & ~(CONSTRAINTS - 1)) | ((node + offset) & (CONSTRAINTS - 1));
+}
+
+/// @brief Add a row to the partial solution by covering all its constraints,
+/// starting with the one of row_node and going right.
+void      selectRow(Mesh* mesh, NodeIndex row_node);
+
+/// @brief Undo selectRow.
+void      deselectRow(Mesh* mesh, NodeIndex row_node);
 
 /// @brief Prints data about each node and it's neighbors.
-void  printDLXMesh(Node* head);
+void  printDLXMesh(Mesh* mesh);
 
-/// @brief Checks that all nodes in the DLX mesh have non-null pointers, prints
-/// a message on failure and continues.
-void  validateDLXMesh(Node* head);
+/// @brief Checks that all nodes in the DLX mesh have links inside the arena,
+/// prints a message on failure and continues.
+void  validateDLXMesh(Mesh* mesh);
 
-/// @brief Frees all nodes, column headers and the head of the DLX mesh.
-void  freeDLXMesh(Node* head);
+/// @brief Frees the arena holding the DLX mesh.
+void  freeDLXMesh(Mesh* mesh);
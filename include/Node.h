@@ -1,22 +1,36 @@
 #pragma once
 
+#include <stdint.h>
 #include <stdlib.h>
 
+#include "Constants.h"
+
+// Nodes live in one flat array and refer to each other by index. Meshes up to
+// 25x25 have fewer than 2^16 nodes, and up to 16x16 fewer than 2^15 rows.
+#if SUDOKU_SIZE <= 25
+typedef uint16_t NodeIndex;
+#else
+typedef uint32_t NodeIndex;
+#endif
+#if SUDOKU_SIZE <= 16
+typedef int16_t RowID;
+#else
+typedef int32_t RowID;
+#endif
+
+// Nodes of a row are consecutive in the arena, so they have no horizontal
+// links, see rowNeighbor in MonkeyFistMesh.h.
 typedef struct node {
-    struct node* left;
-    struct node* right;
-    struct node* up;
-    struct node* down;
-    struct node* column_header;
+    NodeIndex up;
+    NodeIndex down;
+    NodeIndex column_header;
 
-    int          row_ID;  // if -1, then it's a column header
-    int          column_ID;
-    int          nodeCount;
+    RowID     row_ID;  // if -1, then it's a column header
 } Node;
 
-/// @brief Initializes a node with neighbor pointers pointing to itself, column
-/// header set to NULL, and nodeCount set to 0.
-/// @param rowID Row index of the node.
-/// @param columnID Column index of the node.
-/// @return A pointer to the newly created node.
-Node* initNode(int rowID, int columnID);
+/// @brief Initializes a node in place with vertical links pointing to itself.
+/// @param node The storage to initialize.
+/// @param index Index of the node in its mesh.
+/// @param columnHeader Index of the column header, the node itself for headers.
+/// @param rowID Row index of the node, -1 for column headers.
+void initNode(Node* node, NodeIndex index, NodeIndex columnHeader, int rowID);
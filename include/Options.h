@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "InputFunctions.h"
+
+typedef enum Engine {
+    ENGINE_DLX,       // Algorithm X over the dancing links mesh
+    ENGINE_BITSET,    // candidate bitmasks with singles propagation
+    ENGINE_BITCOVER,  // Algorithm X over row bitsets
+    ENGINE_LOCKSTEP,  // bitset propagation of many puzzles at once
+} Engine;
+
+// Most DLX searches one batch thread interleaves.
+#define MAX_INTERLEAVE 16
+
+typedef struct Options {
+    bool         batch;            // solve a stream of puzzles instead of one
+    const char*  input_path;       // NULL to read from the standard input
+    int          threads;          // solving threads, at least 1
+    Engine       engine;
+    int          solution_limit;   // stop after this many solutions, 0 for all
+    bool         propagate;        // DLX selects forced rows before branching
+    bool         decompose;        // DLX counts independent components apart
+    int          interleave;       // DLX searches taking turns per batch thread
+    size_t       table_megabytes;  // DLX transposition table per thread, 0 off
+    PuzzleFormat format;           // of the puzzles read and solutions printed
+} Options;
+
+/// @brief Fill in the default options: one DLX thread solving a single puzzle
+/// from the standard input.
+void        defaultOptions(Options* options);
+
+/// @brief Parse command line arguments into options.
+/// @return false on invalid arguments, after printing usage to stderr.
+bool        parseOptions(int argc, char** argv, Options* options);
+
+/// @brief Print command line usage to stderr.
+void        printUsage(const char* program);
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "Options.h"
+
+// Stop splitting once there are this many subtrees per thread...
+#define PARALLEL_TASKS_PER_THREAD 16
+// ...or the tree has been split at this many branching levels.
+#define PARALLEL_MAX_SPLIT_DEPTH 8
+
+/// @brief Count the solutions of one puzzle on several threads.
+///
+/// The top branching levels of the search tree are expanded on the calling
+/// thread, every unexplored subtree becomes a task described by the rows
+/// chosen on the way to it. Worker threads build a private DLX mesh, replay a
+/// task's rows, search the subtree and add up their solution counts.
+///
+/// With a solution limit every subtree search stops at the limit and no new
+/// tasks are claimed once the threads found enough solutions together.
+///
+/// @param hexadoku A valid puzzle, receives the first solution found.
+/// @param options Number of solving threads (including the calling one) and
+/// search settings.
+/// @return The number of solutions, at most the solution limit.
+int searchSolutionsParallel(uint8_t** hexadoku, const Options* options);
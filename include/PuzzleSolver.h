@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "MonkeyFistMesh.h"
+#include "Options.h"
+#include "SearchStats.h"
+#include "Solver.h"
+
+/// @brief State for solving puzzles one after another with a single engine on
+/// one thread. Buffers are allocated on first use and reused afterwards.
+typedef struct PuzzleSolver {
+    Engine        engine;
+    Mesh*         mesh;  // DLX arena, NULL until the first DLX solve
+    SolverContext context;  // also holds the search settings
+    SearchStats   stats;  // work done by the last solve
+} PuzzleSolver;
+
+/// @brief Initialize a solver for the engine and search settings (solution
+/// limit, propagation, transposition table) of the options.
+void initPuzzleSolver(PuzzleSolver* solver, const Options* options);
+
+/// @brief Count the solutions of a valid puzzle, up to the solution limit.
+/// @param hexadoku The puzzle, receives the first solution found.
+/// @return The number of solutions.
+int  solvePuzzle(PuzzleSolver* solver, uint8_t** hexadoku);
+
+/// @brief Free the buffers owned by the solver.
+void freePuzzleSolver(PuzzleSolver* solver);
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "Constants.h"
+
+// Every cell is decided at most once on a search path, deeper levels cannot
+// occur.
+#define STATS_MAX_DEPTH (SUDOKU_SIZE * SUDOKU_SIZE)
+
+/// @brief Counters describing the work done by one search. They are only
+/// maintained when compiled with -DSEARCH_STATS (as the benchmark is, or
+/// `make STATS=1`), and stay zero otherwise.
+typedef struct SearchStats {
+    uint64_t nodes;              // search tree nodes visited
+    uint64_t covers;             // DLX column covers
+    uint64_t uncovers;           // DLX column uncovers
+    uint64_t placements;         // bitset digits placed
+    uint64_t backtracks;         // dead ends, nodes with nothing to try
+    uint64_t link_updates;       // DLX links rewritten by cover and uncover
+    uint64_t table_hits;         // subtrees counted from the table
+    uint64_t splits;             // nodes counted as independent components
+    uint64_t first_solution_ns;  // search start to first solution, 0 if none
+    uint64_t start_ns;
+    uint64_t depth_nodes[STATS_MAX_DEPTH + 1];     // nodes visited per depth
+    uint64_t depth_branches[STATS_MAX_DEPTH + 1];  // choices tried per depth
+} SearchStats;
+
+/// @brief Print the counters and the per depth histogram in a human readable
+/// form.
+void printSearchStats(FILE* stream, const SearchStats* stats);
+
+#ifdef SEARCH_STATS
+static inline uint64_t statsNowNs(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000u + (uint64_t)time.tv_nsec;
+}
+
+#define STATS_ADD(stats, field, n) \
+    do {                           \
+        (stats)->field += (n);     \
+    } while (false)
+#define STATS_RESET(stats)                    \
+    do {                                      \
+        memset((stats), 0, sizeof(*(stats))); \
+        (stats)->start_ns = statsNowNs();     \
+    } while (false)
+#define STATS_VISIT(stats, depth)           \
+    do {                                    \
+        (stats)->nodes++;                   \
+        (stats)->depth_nodes[(depth)]++;    \
+    } while (false)
+#define STATS_BRANCH(stats, depth)          \
+    do {                                    \
+        (stats)->depth_branches[(depth)]++; \
+    } while (false)
+#define STATS_SOLUTION(stats)                                             \
+    do {                                                                  \
+        if ((stats)->first_solution_ns == 0)                              \
+            (stats)->first_solution_ns = statsNowNs() - (stats)->start_ns; \
+    } while (false)
+#else
+// n is not evaluated, but counts as used
+#define STATS_ADD(stats, field, n) \
+    do {                           \
+        (void)sizeof(n);           \
+    } while (false)
+#define STATS_RESET(stats) \
+    do {                   \
+    } while (false)
+#define STATS_VISIT(stats, depth) \
+    do {                          \
+    } while (false)
+#define STATS_BRANCH(stats, depth) \
+    do {                           \
+    } while (false)
+#define STATS_SOLUTION(stats) \
+    do {                      \
+    } while (false)
+#endif
@@ -1,42 +1,148 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
+#include "IntVector.h"
+#include "MonkeyFistMesh.h"
 #include "Node.h"
+#include "TranspositionTable.h"
+
+// Every level of the search fills one cell, so the decision stack never grows
+// deeper than the grid.
+#define SEARCH_STACK_SIZE (SUDOKU_SIZE * SUDOKU_SIZE)
+
+/// @brief One level of the search: the column branched on and the row of it
+/// currently selected (the column header itself before the first row), and
+/// the part of the trail holding the rows forced before the column was
+/// chosen. With a transposition table it also keeps the key of the node and
+/// the solutions counted before it, to store the count of its subtree.
+typedef struct SearchFrame {
+    NodeIndex column;
+    NodeIndex row_node;
+    uint16_t  trail_start;
+    uint16_t  trail_end;
+    int       solutions_before;
+    uint64_t  key;
+} SearchFrame;
+
+/// @brief State of one search. Every thread solving puzzles owns its own
+/// context together with its own DLX mesh. The decision stack and the mesh
+/// together describe the search completely, so it can be inspected between
+/// steps.
+typedef struct SolverContext {
+    uint8_t**           hexadoku;  // receives the first solution found
+    int                 solution_count;
+    int                 solution_limit;  // stop after this many, 0 for all
+    bool                propagate;       // select forced rows before branching
+    bool                decompose;  // count independent components apart
+    TranspositionTable* table;  // subtree solution counts, NULL for none
+    uint64_t            key;    // Zobrist key of the covered columns
+    int                 depth;  // levels on the stack
+    int                 base_depth;  // levels of the enclosing searches
+    int                 trail_size;
+    SearchFrame         stack[SEARCH_STACK_SIZE];
+    NodeIndex trail[SEARCH_STACK_SIZE];  // forced rows, in selection order
+    // columns of the components found by the decomposition, each nested
+    // search has a context of its own
+    bool                reached[MESH_WIDTH + 1];
+    NodeIndex           component[MESH_WIDTH];
+    NodeIndex           rest[MESH_WIDTH];
+} SolverContext;
+
+/// @brief Reset the context for a new puzzle, keeping the solution limit, the
+/// propagation and decomposition switches and the transposition table. The
+/// hints of the hexadoku must be the only rows selected in the mesh.
+void      resetSolverContext(SolverContext* context, uint8_t** hexadoku);
+
+/// @brief Algorithm X over the DLX mesh. Counts the solutions up to the
+/// context's limit and writes the cells chosen by the first one into the
+/// context's hexadoku. Once the limit is reached the search unwinds right
+/// away, restoring the mesh.
+///
+/// @details The search is iterative: every level keeps its column and current
+/// row in the context's fixed size decision stack, and backtracking advances
+/// the deepest level that still has rows left.
+///
+/// With propagation on, every node of the search first selects the only row
+/// of each column that has just one (a naked single for a cell constraint, a
+/// hidden single for the others), as long as there are such columns and no
+/// empty one. The forced rows are kept on the trail and undone as a group
+/// when the search backtracks past the node.
+///
+/// With decomposition on, a node whose open columns fall apart into groups
+/// sharing no rows counts the groups with nested searches and adds the product
+/// of their counts, instead of enumerating every combination of their
+/// solutions.
+///
+/// With a transposition table, a node whose covered columns are in the table
+/// adds the stored count instead of being searched, and every level that was
+/// searched completely stores its count. Counts cut short by the solution
+/// limit are not stored.
+/// @param context The search state, with an empty stack.
+/// @param mesh The DLX mesh.
+void      searchSolutions(SolverContext* context, Mesh* mesh);
+
+/// @brief Visit one node of the search started by resetSolverContext, as
+/// searchSolutions does in a loop, so that several searches can take turns.
+/// @return false once the search is finished and the mesh restored.
+bool      stepSearch(SolverContext* context, Mesh* mesh);
+
+/// @brief Prefetch the nodes the next step of the search reads first, the
+/// smallest column and its first row, so that they arrive while other
+/// searches take their turns.
+void      prefetchSearchStep(const Mesh* mesh);
+
+/// @brief Write the exact cover rows of a solution into the hexadoku.
+void      solutionToHexadoku(IntVector* solution, uint8_t** hexadoku);
 
 /// @brief Mark constraint as covered.
+/// @param mesh The mesh the column belongs to.
 /// @param column_header The column header of the corresponding constraint.
 ///
-/// @details Cover iterates over all rows that can no longer be used, because
-/// they contain a node in the already satisfied column. It detaches all the
-/// nodes in such rows from their vertical neighbors and decrements the node
-/// count of their respective column header.
-void  cover(Node* column_header);
+/// @details Cover takes the column out of its size bucket and iterates over
+/// all rows that can no longer be used, because they contain a node in the
+/// already satisfied column. It detaches the other three nodes of each such
+/// row, addressed directly in its node group, from their vertical neighbors,
+/// decrements the node count of their respective column header and moves that
+/// column to the next smaller bucket.
+void      cover(Mesh* mesh, NodeIndex column_header);
 
 /// @brief Uncover constraint, i.e. make it available again (undo cover).
+/// @param mesh The mesh the column belongs to.
 /// @param column_header The column header of the corresponding constraint.
 ///
 /// @details Uncover iterates over all rows that can be used again, because they
-/// contain a node in the uncovered column. It reattaches all the nodes in such
-/// rows to their vertical neighbors and increments the node count of their
-/// respective column header.
-void  uncover(Node* column_header);
+/// contain a node in the uncovered column. It reattaches the other nodes of
+/// each such row, in reverse order, to their vertical neighbors, increments
+/// the node count of their respective column header and moves that column to
+/// the next larger bucket.
+/// Finally the column itself is filed under its size again.
+void      uncover(Mesh* mesh, NodeIndex column_header);
 
-/// @brief  Get the first column header with the fewest node count.
-Node* getMinColumn(Node* head);
+/// @brief Cover the columns of the other nodes of a row, going right from
+/// row_node, once the search picked the row from row_node's column.
+void      coverRowNeighbors(Mesh* mesh, NodeIndex row_node);
 
-/// @brief  Link neighboring nodes' pointers with each other to bypass node.
-/// @param  node The node to bypass.
-void  unlinkHorizontal(Node* node);
-/// @brief  Point relevant left and right pointers of neighbors to node.
-/// @param  node The node to link with.
+/// @brief Undo coverRowNeighbors, going left.
+void      uncoverRowNeighbors(Mesh* mesh, NodeIndex row_node);
+
+/// @brief  Get a column header with the fewest node count, the first one of
+/// the smallest non-empty size bucket.
+NodeIndex getMinColumn(Mesh* mesh);
+
+/// @brief  File an uncovered column under the given size.
+void      bucketInsert(Mesh* mesh, NodeIndex column_header, int size);
 
-void  relinkHorizontal(Node* node);
+/// @brief  Take a column out of its size bucket.
+void      bucketRemove(Mesh* mesh, NodeIndex column_header, int size);
 
-/// @brief  Link neighboring nodes' pointers with each other to bypass node.
+/// @brief  Link neighboring nodes' indices with each other to bypass node.
+/// @param  nodes The node arena.
 /// @param  node The node to bypass.
-void  unlinkVertical(Node* node);
+void      unlinkVertical(Node* nodes, NodeIndex node);
 
-/// @brief  Point relevant up and down pointers of neighbors to node.
+/// @brief  Point relevant up and down links of neighbors to node.
+/// @param  nodes The node arena.
 /// @param  node The node to link with.
-void  relinkVertical(Node* node);
+void      relinkVertical(Node* nodes, NodeIndex node);
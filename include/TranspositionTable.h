@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// @brief One remembered subproblem: the Zobrist key of its covered columns
+/// and the number of solutions below it.
+typedef struct TableEntry {
+    uint64_t key;
+    int32_t  solution_count;
+    uint16_t depth;       // search depth it was stored at, shallower is bigger
+    uint16_t generation;  // entries of older generations are empty
+} TableEntry;
+
+// Entries sharing one cache line, any of them can hold a key.
+#define TABLE_BUCKET_SIZE 4
+
+/// @brief Fixed size cache of subtree solution counts, shared by the searches
+/// of one thread.
+///
+/// The open part of an exact cover problem only depends on which columns are
+/// covered, not on the rows that covered them or their order, so different
+/// paths of the search that cover the same columns have the same number of
+/// solutions below them. The key of a node is the XOR of a random 64-bit key
+/// of every covered constraint, hints included, so entries stay valid from
+/// one puzzle to the next.
+///
+/// Keys go to a bucket of TABLE_BUCKET_SIZE entries. A full bucket replaces
+/// its deepest entry, which saved the least work, unless the new one is
+/// deeper still.
+typedef struct TranspositionTable {
+    TableEntry* entries;
+    size_t      bucket_mask;  // bucket count - 1, a power of two
+    uint16_t    generation;   // of the entries in use, never 0
+} TranspositionTable;
+
+/// @brief Allocate an empty table using at most the given number of
+/// megabytes, rounded down to a power of two number of buckets.
+/// @return NULL if megabytes is 0 or the memory is not available.
+TranspositionTable* createTranspositionTable(size_t megabytes);
+
+/// @brief Free a table allocated with createTranspositionTable.
+void                freeTranspositionTable(TranspositionTable* table);
+
+/// @brief Forget every entry, e.g. to time searches independently. Only
+/// starts a new generation, the memory is cleared once in 65535 calls.
+void                clearTranspositionTable(TranspositionTable* table);
+
+/// @brief Zobrist key contribution of an exact cover row: the XOR of the keys
+/// of its constraints.
+uint64_t            rowKey(int row);
+
+/// @brief Look up the solution count of a subproblem.
+/// @return false if the key is not in the table.
+bool probeTranspositionTable(const TranspositionTable* table, uint64_t key,
+                             int* solution_count);
+
+/// @brief Remember the solution count of a completely searched subproblem.
+void storeTranspositionTable(TranspositionTable* table, uint64_t key,
+                             int solution_count, int depth);
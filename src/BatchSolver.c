@@ -0,0 +1,301 @@
+#include "BatchSolver.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "Hexadoku.h"
+#include "InputFunctions.h"
+#include "LockstepSolver.h"
+#include "PuzzleSolver.h"
+#include "Solver.h"
+
+typedef struct BatchSlot {
+    uint8_t**  hexadoku;  // the puzzle, replaced by its first solution
+    ReadStatus status;
+    int        solution_count;
+    bool       solved;  // the result waits to be printed
+} BatchSlot;
+
+// Ring of the puzzles between the reader, the workers and the printing of the
+// results. Puzzles are counted in input order, puzzle i occupies slot
+// i % BATCH_QUEUE_SIZE from the time it is read until its result is printed.
+typedef struct BatchQueue {
+    BatchSlot       slots[BATCH_QUEUE_SIZE];
+    long long       read;      // puzzles read so far
+    long long       claimed;   // puzzles handed to workers so far
+    long long       printed;   // puzzles whose result was printed so far
+    bool            done;      // the input is exhausted
+    bool            printing;  // a worker is printing results
+    const Options*  options;
+    pthread_mutex_t lock;
+    pthread_cond_t  filled;   // a puzzle was read, or the input ended
+    pthread_cond_t  emptied;  // a slot was freed by printing its result
+} BatchQueue;
+
+// One of the DLX searches a worker interleaves.
+typedef struct BatchLane {
+    BatchSlot*    slot;  // puzzle being solved, NULL when the lane is idle
+    Mesh*         mesh;
+    SolverContext context;
+} BatchLane;
+
+typedef struct BatchWorker {
+    BatchQueue*  queue;
+    PuzzleSolver solver;  // buffers reused for every puzzle of this worker
+    BatchLane*   lanes;   // NULL unless DLX searches are interleaved
+    int          lane_count;
+    pthread_t    thread;
+} BatchWorker;
+
+
+// Mark slots that can not be solved.
+// @return true if the slot holds a valid puzzle.
+static bool checkSlot(BatchSlot* slot) {
+    if (slot->status != READ_OK) return false;
+    if (!isHexadokuValid(slot->hexadoku)) {
+        slot->status = READ_INVALID;
+        return false;
+    }
+    return true;
+}
+
+static void printSlot(const BatchSlot* slot, const Options* options) {
+    if (slot->status != READ_OK)
+        printf("Nespravny vstup.\n");
+    else
+        printSolveResult(slot->hexadoku, slot->solution_count,
+                         options->solution_limit, options->format);
+}
+
+// Record the result of a claimed puzzle, then print every result that is next
+// in input order, unless another worker is already printing them.
+static void finishSlot(BatchQueue* queue, BatchSlot* slot, int solution_count) {
+    pthread_mutex_lock(&queue->lock);
+    slot->solution_count = solution_count;
+    slot->solved         = true;
+    if (!queue->printing) {
+        queue->printing = true;
+        for (;;) {
+            BatchSlot* next = &queue->slots[queue->printed % BATCH_QUEUE_SIZE];
+            if (!next->solved) break;
+            pthread_mutex_unlock(&queue->lock);
+            printSlot(next, queue->options);
+            pthread_mutex_lock(&queue->lock);
+            next->solved = false;
+            queue->printed++;
+            pthread_cond_signal(&queue->emptied);
+        }
+        queue->printing = false;
+    }
+    pthread_mutex_unlock(&queue->lock);
+}
+
+// Claim the next puzzle read, waiting for the reader if wait is set.
+// @return NULL if there is none to claim now, exhausted is then set if none
+// will come.
+static BatchSlot* claimSlot(BatchQueue* queue, bool wait, bool* exhausted) {
+    BatchSlot* slot = NULL;
+    pthread_mutex_lock(&queue->lock);
+    while (wait && queue->claimed == queue->read && !queue->done)
+        pthread_cond_wait(&queue->filled, &queue->lock);
+    if (queue->claimed < queue->read)
+        slot = &queue->slots[queue->claimed++ % BATCH_QUEUE_SIZE];
+    *exhausted = slot == NULL && queue->done;
+    pthread_mutex_unlock(&queue->lock);
+    return slot;
+}
+
+// Claim the next valid puzzle like claimSlot, finishing invalid ones on the
+// way.
+static BatchSlot* claimPuzzle(BatchQueue* queue, bool wait, bool* exhausted) {
+    BatchSlot* slot;
+    while ((slot = claimSlot(queue, wait, exhausted)) != NULL &&
+           !checkSlot(slot))
+        finishSlot(queue, slot, 0);
+    return slot;
+}
+
+// Solve puzzles one by one until the input is exhausted.
+static void runSolver(BatchWorker* worker) {
+    BatchQueue* queue = worker->queue;
+    BatchSlot*  slot;
+    bool        exhausted;
+    while ((slot = claimPuzzle(queue, true, &exhausted)) != NULL)
+        finishSlot(queue, slot, solvePuzzle(&worker->solver, slot->hexadoku));
+}
+
+// Start the search of the next valid puzzle on the lane.
+// @return false if there is none, the lane is then idle.
+static bool startLane(BatchWorker* worker, BatchLane* lane, bool wait,
+                      bool* exhausted) {
+    lane->slot = claimPuzzle(worker->queue, wait, exhausted);
+    if (lane->slot == NULL) return false;
+    lane->mesh = createDLXMesh(lane->slot->hexadoku, lane->mesh);
+    resetSolverContext(&lane->context, lane->slot->hexadoku);
+    return true;
+}
+
+// Solve puzzles like runSolver, but keep a search running on every lane and
+// let them take one step each in turn. A step mostly waits for nodes of the
+// mesh, which is prefetched for the lane's next step before moving on, so
+// the misses of one search overlap with the work of the others.
+static void runInterleaved(BatchWorker* worker) {
+    int  active    = 0;
+    bool exhausted = false;
+    for (;;) {
+        for (int i = 0; i < worker->lane_count; i++) {
+            BatchLane* lane = &worker->lanes[i];
+            if (lane->slot == NULL) {
+                // Only wait for the reader with no search running: the
+                // reader may itself wait for the results of those searches
+                // to be printed.
+                if (exhausted ||
+                    !startLane(worker, lane, active == 0, &exhausted))
+                    continue;
+                active++;
+            }
+            if (stepSearch(&lane->context, lane->mesh)) {
+                prefetchSearchStep(lane->mesh);
+                continue;
+            }
+            finishSlot(worker->queue, lane->slot, lane->context.solution_count);
+            lane->slot = NULL;
+            active--;
+        }
+        if (active == 0 && exhausted) return;
+    }
+}
+
+// Claim valid puzzles until every lockstep lane has one, solve them together
+// and repeat until the input is exhausted. Only the first puzzle is waited
+// for, the lanes left over while the reader is behind stay idle.
+static void runLockstep(BatchWorker* worker) {
+    BatchQueue* queue     = worker->queue;
+    bool        exhausted = false;
+    while (!exhausted) {
+        BatchSlot* slots[LOCKSTEP_LANES];
+        uint8_t**  puzzles[LOCKSTEP_LANES];
+        int        solution_counts[LOCKSTEP_LANES];
+        int        count = 0;
+        BatchSlot* slot;
+        while (count < LOCKSTEP_LANES &&
+               (slot = claimPuzzle(queue, count == 0, &exhausted)) != NULL) {
+            slots[count]     = slot;
+            puzzles[count++] = slot->hexadoku;
+        }
+        if (count == 0) return;
+
+        solveLockstep(puzzles, count, worker->solver.context.solution_limit,
+                      solution_counts, &worker->solver.stats);
+        for (int i = 0; i < count; i++)
+            finishSlot(queue, slots[i], solution_counts[i]);
+    }
+}
+
+static void initWorker(BatchWorker* worker, BatchQueue* queue,
+                       const Options* options) {
+    worker->queue      = queue;
+    worker->lanes      = NULL;
+    worker->lane_count = 0;
+    initPuzzleSolver(&worker->solver, options);
+    if (options->engine != ENGINE_DLX || options->interleave < 2) return;
+
+    worker->lane_count = options->interleave;
+    worker->lanes = (BatchLane*)malloc(worker->lane_count * sizeof(BatchLane));
+    for (int i = 0; i < worker->lane_count; i++) {
+        worker->lanes[i].slot                   = NULL;
+        worker->lanes[i].mesh                   = NULL;
+        worker->lanes[i].context.solution_limit = options->solution_limit;
+        worker->lanes[i].context.propagate      = options->propagate;
+        worker->lanes[i].context.decompose      = options->decompose;
+        // the lanes of a thread take turns, so they can share its table
+        worker->lanes[i].context.table = worker->solver.context.table;
+    }
+}
+
+static void freeWorker(BatchWorker* worker) {
+    freePuzzleSolver(&worker->solver);
+    for (int i = 0; i < worker->lane_count; i++)
+        if (worker->lanes[i].mesh != NULL) freeDLXMesh(worker->lanes[i].mesh);
+    free(worker->lanes);
+}
+
+static void* workerLoop(void* arg) {
+    BatchWorker* worker = (BatchWorker*)arg;
+    if (worker->solver.engine == ENGINE_LOCKSTEP)
+        runLockstep(worker);
+    else if (worker->lanes != NULL)
+        runInterleaved(worker);
+    else
+        runSolver(worker);
+    return NULL;
+}
+
+// Read records into free slots until the input is exhausted.
+static void readPuzzles(PuzzleReader* reader, BatchQueue* queue) {
+    for (;;) {
+        pthread_mutex_lock(&queue->lock);
+        while (queue->read - queue->printed == BATCH_QUEUE_SIZE)
+            pthread_cond_wait(&queue->emptied, &queue->lock);
+        pthread_mutex_unlock(&queue->lock);
+
+        // the slot is the reader's own until the puzzle is counted as read
+        BatchSlot* slot = &queue->slots[queue->read % BATCH_QUEUE_SIZE];
+        slot->status    = readPuzzleRecord(reader, queue->options->format,
+                                           slot->hexadoku, true);
+
+        pthread_mutex_lock(&queue->lock);
+        if (slot->status == READ_EOF) {
+            queue->done = true;
+            pthread_cond_broadcast(&queue->filled);
+        } else {
+            queue->read++;
+            pthread_cond_signal(&queue->filled);
+        }
+        pthread_mutex_unlock(&queue->lock);
+        if (slot->status == READ_EOF) return;
+    }
+}
+
+int solveBatch(FILE* input, const Options* options) {
+    int           threads = options->threads;
+    PuzzleReader* reader  = createPuzzleReader(input);
+    BatchQueue*   queue   = (BatchQueue*)malloc(sizeof(BatchQueue));
+    for (int i = 0; i < BATCH_QUEUE_SIZE; i++) {
+        queue->slots[i].hexadoku = createHexadoku();
+        queue->slots[i].solved   = false;
+    }
+    queue->read     = 0;
+    queue->claimed  = 0;
+    queue->printed  = 0;
+    queue->done     = false;
+    queue->printing = false;
+    queue->options  = options;
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->filled, NULL);
+    pthread_cond_init(&queue->emptied, NULL);
+
+    // the calling thread reads while the workers solve
+    BatchWorker* workers = (BatchWorker*)malloc(threads * sizeof(BatchWorker));
+    for (int i = 0; i < threads; i++) {
+        initWorker(&workers[i], queue, options);
+        pthread_create(&workers[i].thread, NULL, workerLoop, &workers[i]);
+    }
+    readPuzzles(reader, queue);
+
+    for (int i = 0; i < threads; i++) {
+        pthread_join(workers[i].thread, NULL);
+        freeWorker(&workers[i]);
+    }
+    free(workers);
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->filled);
+    pthread_cond_destroy(&queue->emptied);
+    for (int i = 0; i < BATCH_QUEUE_SIZE; i++)
+        freeHexadoku(queue->slots[i].hexadoku);
+    free(queue);
+    freePuzzleReader(reader);
+
+    return 0;
+}
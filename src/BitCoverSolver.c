@@ -0,0 +1,257 @@
+#include "BitCoverSolver.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CandidateKernel.h"
+#include "Hexadoku.h"
+
+// Removes the rows of the masks from the live set and returns them in dropped.
+typedef void (*DropKernel)(uint64_t* live, const uint64_t* const* masks,
+                           uint64_t* dropped);
+// Smallest of the column sizes.
+typedef uint8_t (*MinSizeKernel)(const uint8_t* column_sizes);
+
+// A mask over all rows per column takes MESH_WIDTH * MESH_ROWS bits, 30 MB for
+// 36x36 grids but 512 MB for 64x64 ones. Larger grids drop the live rows of a
+// chosen row's columns one by one from the column lists instead.
+#define COLUMN_MASKS (SUDOKU_SIZE <= 36)
+
+typedef struct BitCoverSearch {
+    uint8_t**      hexadoku;  // receives the first solution found
+    int            solution_count;
+    int            solution_limit;  // 0 for no limit
+    DropKernel     drop_rows;
+    MinSizeKernel  min_size;
+    SearchStats*   stats;
+    // The state of every level, allocated when the level is first reached:
+    // forced rows are selected in place, so most searches branch on far fewer
+    // levels than there are cells.
+    BitCoverState* states[SEARCH_LEVELS];
+#if COLUMN_MASKS
+    uint64_t       dropped[ROW_WORDS];  // rows dropped by the chosen row
+#endif
+} BitCoverSearch;
+
+// Rows of every column as a mask over all rows, and as the list shared with
+// the DLX mesh.
+#if COLUMN_MASKS
+static uint64_t          column_masks[MESH_WIDTH][ROW_WORDS];
+#endif
+static const ColumnRows* column_rows;
+// Columns of every row.
+static uint16_t          row_columns[MESH_ROWS][CONSTRAINTS];
+static pthread_once_t    tables_once = PTHREAD_ONCE_INIT;
+
+static void initTables(void) {
+    column_rows = emptyGridColumnRows();
+    for (int row = 0; row < MESH_ROWS; row++) {
+        int constraints[CONSTRAINTS];
+        rowConstraints(row, constraints);
+        for (int i = 0; i < CONSTRAINTS; i++) {
+            int column = constraints[i];
+#if COLUMN_MASKS
+            column_masks[column][row / 64] |= 1ull << (row % 64);
+#endif
+            row_columns[row][i] = column;
+        }
+    }
+}
+
+// The kernels are plain loops over whole words and bytes. They are compiled
+// once for the baseline ISA and once for AVX2, picked at runtime like the
+// candidate kernels of the bitset engine.
+static inline __attribute__((always_inline)) void dropRows(
+    uint64_t* live, const uint64_t* const* masks, uint64_t* dropped) {
+    for (int word = 0; word < ROW_WORDS; word++) {
+        dropped[word] = live[word] & (masks[0][word] | masks[1][word] |
+                                      masks[2][word] | masks[3][word]);
+        live[word] &= ~dropped[word];
+    }
+}
+
+static inline __attribute__((always_inline)) uint8_t minSize(
+    const uint8_t* column_sizes) {
+    uint8_t min = COVERED_COLUMN;
+    for (int column = 0; column < MESH_WIDTH; column++)
+        if (column_sizes[column] < min) min = column_sizes[column];
+    return min;
+}
+
+static void dropRowsBaseline(uint64_t* live, const uint64_t* const* masks,
+                             uint64_t* dropped) {
+    dropRows(live, masks, dropped);
+}
+
+static uint8_t minSizeBaseline(const uint8_t* column_sizes) {
+    return minSize(column_sizes);
+}
+
+#ifdef HAS_X86_KERNELS
+__attribute__((target("avx2"))) static void dropRowsAVX2(
+    uint64_t* live, const uint64_t* const* masks, uint64_t* dropped) {
+    dropRows(live, masks, dropped);
+}
+
+__attribute__((target("avx2"))) static uint8_t minSizeAVX2(
+    const uint8_t* column_sizes) {
+    return minSize(column_sizes);
+}
+#endif
+
+static void selectKernels(BitCoverSearch* search) {
+    search->drop_rows = dropRowsBaseline;
+    search->min_size  = minSizeBaseline;
+#ifdef HAS_X86_KERNELS
+    if (strcmp(candidateKernelName(), "avx2") == 0) {
+        search->drop_rows = dropRowsAVX2;
+        search->min_size  = minSizeAVX2;
+    }
+#endif
+}
+
+static inline bool isRowLive(const BitCoverState* state, int row) {
+    return state->live[row / 64] & (1ull << (row % 64));
+}
+
+// Choose the row: every row sharing a column with it drops out of the live set
+// and its columns shrink, then the columns of the row are covered. A dropped
+// row never has a column that was covered before, as it would have dropped out
+// then, so only the columns covered now are decremented needlessly.
+static void chooseRow(BitCoverSearch* search, BitCoverState* state, int row) {
+#if COLUMN_MASKS
+    const uint64_t* masks[CONSTRAINTS];
+    for (int i = 0; i < CONSTRAINTS; i++)
+        masks[i] = column_masks[row_columns[row][i]];
+
+    uint64_t* dropped = search->dropped;
+    search->drop_rows(state->live, masks, dropped);
+
+    for (int word = 0; word < ROW_WORDS; word++) {
+        for (uint64_t bits = dropped[word]; bits != 0; bits &= bits - 1) {
+            const uint16_t* columns =
+                row_columns[word * 64 + __builtin_ctzll(bits)];
+            for (int i = 0; i < CONSTRAINTS; i++)
+                state->column_sizes[columns[i]]--;
+        }
+    }
+#else
+    for (int i = 0; i < CONSTRAINTS; i++) {
+        const RowID* rows = column_rows[row_columns[row][i]];
+        for (int j = 0; j < MAX_COLUMN_SIZE; j++) {
+            int dropped = rows[j];
+            if (!isRowLive(state, dropped)) continue;
+            state->live[dropped / 64] &= ~(1ull << (dropped % 64));
+            const uint16_t* columns = row_columns[dropped];
+            for (int k = 0; k < CONSTRAINTS; k++)
+                state->column_sizes[columns[k]]--;
+        }
+    }
+#endif
+    for (int i = 0; i < CONSTRAINTS; i++)
+        state->column_sizes[row_columns[row][i]] = COVERED_COLUMN;
+
+    state->cells[row / SUDOKU_SIZE] = row % SUDOKU_SIZE + 1;
+    STATS_ADD(search->stats, covers, CONSTRAINTS);
+}
+
+// The open column with the fewest live rows (the lowest index among equals),
+// or -1 if every column is covered. The minimum is taken over all columns
+// first, which compiles to a vectorized byte minimum, and then located.
+static int smallestColumn(const BitCoverSearch* search,
+                          const BitCoverState* state) {
+    uint8_t min = search->min_size(state->column_sizes);
+    if (min == COVERED_COLUMN) return -1;
+
+    const uint8_t* found =
+        (const uint8_t*)memchr(state->column_sizes, min, MESH_WIDTH);
+    return (int)(found - state->column_sizes);
+}
+
+static int firstLiveRow(const BitCoverState* state, int column) {
+    int i = 0;
+    while (!isRowLive(state, column_rows[column][i])) i++;
+    return column_rows[column][i];
+}
+
+static BitCoverState* stateAt(BitCoverSearch* search, int depth) {
+    if (search->states[depth] == NULL)
+        search->states[depth] = (BitCoverState*)malloc(sizeof(BitCoverState));
+    return search->states[depth];
+}
+
+// Search below the state of the given depth.
+static void searchBitCover(BitCoverSearch* search, int depth) {
+    BitCoverState* state = search->states[depth];
+    STATS_VISIT(search->stats, depth);
+    // a column with a single row leaves no choice, and nothing to restore
+    int column;
+    while ((column = smallestColumn(search, state)) != -1 &&
+           state->column_sizes[column] == 1) {
+        chooseRow(search, state, firstLiveRow(state, column));
+        STATS_ADD(search->stats, placements, 1);
+    }
+
+    if (column == -1) {
+        STATS_SOLUTION(search->stats);
+        if (search->solution_count == 0)
+            for (int row = 0; row < SUDOKU_SIZE; row++)
+                memcpy(search->hexadoku[row], &state->cells[row * SUDOKU_SIZE],
+                       SUDOKU_SIZE);
+        search->solution_count++;
+        return;
+    }
+    if (state->column_sizes[column] == 0) {
+        STATS_ADD(search->stats, backtracks, 1);
+        return;
+    }
+
+    for (int i = 0; i < MAX_COLUMN_SIZE; i++) {
+        int row = column_rows[column][i];
+        if (!isRowLive(state, row)) continue;
+
+        BitCoverState* child = stateAt(search, depth + 1);
+        *child               = *state;
+        chooseRow(search, child, row);
+        STATS_ADD(search->stats, placements, 1);
+        STATS_BRANCH(search->stats, depth);
+        searchBitCover(search, depth + 1);
+        if (isSolutionLimitReached(search->solution_count,
+                                   search->solution_limit))
+            return;
+    }
+}
+
+int searchSolutionsBitCover(uint8_t** hexadoku, int solution_limit,
+                            SearchStats* stats) {
+    pthread_once(&tables_once, initTables);
+
+    BitCoverSearch search = {hexadoku, 0, solution_limit, NULL, NULL, stats,
+                             {NULL}};
+    selectKernels(&search);
+
+    BitCoverState* state = stateAt(&search, 0);
+    memset(state->live, 0xFF, sizeof(state->live));
+    memset(state->column_sizes, MAX_COLUMN_SIZE, sizeof(state->column_sizes));
+    memset(state->cells, 0, sizeof(state->cells));
+
+    bool is_valid = true;
+    for (int cell = 0; cell < SUDOKU_SIZE * SUDOKU_SIZE && is_valid; cell++) {
+        int digit = hexadoku[cell / SUDOKU_SIZE][cell % SUDOKU_SIZE];
+        if (digit == 0) continue;
+        int row = cell * SUDOKU_SIZE + digit - 1;
+        // an earlier hint took the digit or the cell
+        is_valid = isRowLive(state, row);
+        if (is_valid) chooseRow(&search, state, row);
+    }
+
+    if (is_valid) {
+        STATS_RESET(stats);
+        searchBitCover(&search, 0);
+    }
+    for (int depth = 0; depth < SEARCH_LEVELS && search.states[depth] != NULL;
+         depth++)
+        free(search.states[depth]);
+    return search.solution_count;
+}
@@ -0,0 +1,188 @@
+#include "BitsetSolver.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "CandidateKernel.h"
+#include "Hexadoku.h"
+
+typedef struct BitsetSearch {
+    uint8_t**       hexadoku;  // receives the first solution found
+    int             solution_count;
+    int             solution_limit;  // 0 for no limit
+    CandidateKernel kernel;
+    SearchStats*    stats;
+    // The grid of every level, allocated when the level is first reached.
+    // They are kept on the heap, a copy per stack frame would overflow the
+    // stack for 64x64 grids.
+    BitsetGrid*     grids[SEARCH_LEVELS];
+    DigitMask       candidates[SUDOKU_SIZE * SUDOKU_SIZE];
+} BitsetSearch;
+
+static inline DigitMask unitMask(const BitsetGrid* grid, int unit) {
+    int index = unit % SUDOKU_SIZE;
+    switch (unit / SUDOKU_SIZE) {
+        case 0:
+            return grid->rows[index];
+        case 1:
+            return grid->columns[index];
+        default:
+            return grid->boxes[index];
+    }
+}
+
+DigitMask cellCandidates(const BitsetGrid* grid, int cell) {
+    return ~(grid->rows[rowOfCell(cell)] | grid->columns[columnOfCell(cell)] |
+             grid->boxes[boxOfCell(cell)]) &
+           FULL_DIGIT_MASK;
+}
+
+void placeDigit(BitsetGrid* grid, int cell, int digit) {
+    DigitMask bit     = DIGIT_BIT(digit);
+    grid->cells[cell] = digit;
+    grid->rows[rowOfCell(cell)] |= bit;
+    grid->columns[columnOfCell(cell)] |= bit;
+    grid->boxes[boxOfCell(cell)] |= bit;
+    grid->empty_cells--;
+}
+
+// Place every cell that had a single candidate when the candidates were
+// computed, starting from the first one.
+static bool placeNakedSingles(BitsetGrid* grid, const DigitMask* candidates,
+                              int first_cell) {
+    for (int cell = first_cell; cell < SUDOKU_SIZE * SUDOKU_SIZE; cell++) {
+        DigitMask single = candidates[cell];
+        if (single == 0 || (single & (single - 1)) != 0) continue;
+        // an earlier placement of this pass may have taken the digit
+        if ((cellCandidates(grid, cell) & single) == 0) return false;
+        placeDigit(grid, cell, lowestDigit(single));
+    }
+    return true;
+}
+
+// Place every digit that fits into a single cell of some unit. Digits seen
+// once and digits seen at least twice are tracked as two masks per unit.
+// Candidates only shrink while placing, so masks computed before the pass
+// never report a false contradiction, and every placement is checked against
+// the current grid.
+static bool placeHiddenSingles(BitsetGrid* grid, const DigitMask* candidates,
+                               bool* changed) {
+    for (int unit = 0; unit < 3 * SUDOKU_SIZE; unit++) {
+        DigitMask once  = 0;
+        DigitMask twice = 0;
+        for (int i = 0; i < SUDOKU_SIZE; i++) {
+            DigitMask cell_candidates = candidates[unitCell(unit, i)];
+            twice |= once & cell_candidates;
+            once |= cell_candidates;
+        }
+        // some digit can not be placed anywhere in this unit
+        if ((once | unitMask(grid, unit)) != FULL_DIGIT_MASK) return false;
+
+        DigitMask hidden = once & ~twice & ~unitMask(grid, unit);
+        while (hidden != 0) {
+            DigitMask bit = hidden & -hidden;
+            hidden &= hidden - 1;
+
+            int i = 0;
+            while (!(candidates[unitCell(unit, i)] & bit)) i++;
+            int cell = unitCell(unit, i);
+            // the cell was taken by a placement of this pass
+            if (grid->cells[cell] != 0 || !(cellCandidates(grid, cell) & bit)) {
+                if (unitMask(grid, unit) & bit) continue;
+                return false;
+            }
+            placeDigit(grid, cell, lowestDigit(bit));
+            *changed = true;
+        }
+    }
+    return true;
+}
+
+bool propagateSingles(BitsetGrid* grid, CandidateKernel kernel,
+                      DigitMask* candidates, int* min_cell) {
+    for (;;) {
+        int min_count;
+        *min_cell = kernel(grid, candidates, &min_count);
+        if (*min_cell == -1) return true;
+        if (min_count == 0) return false;
+        if (min_count == 1) {
+            if (!placeNakedSingles(grid, candidates, *min_cell)) return false;
+            continue;
+        }
+
+        // no naked singles, so the candidates are exact for the hidden pass,
+        // and if it places nothing the most constrained cell is still valid
+        bool changed = false;
+        if (!placeHiddenSingles(grid, candidates, &changed)) return false;
+        if (!changed) return true;
+    }
+}
+
+static BitsetGrid* gridAt(BitsetSearch* search, int depth) {
+    if (search->grids[depth] == NULL)
+        search->grids[depth] = (BitsetGrid*)malloc(sizeof(BitsetGrid));
+    return search->grids[depth];
+}
+
+// Search below the grid of the given depth.
+static void searchBitset(BitsetSearch* search, int depth) {
+    BitsetGrid* grid = search->grids[depth];
+    STATS_VISIT(search->stats, depth);
+    // propagation places as many digits as it fills empty cells
+    STATS_ADD(search->stats, placements, grid->empty_cells);
+    int  cell;
+    bool solvable =
+        propagateSingles(grid, search->kernel, search->candidates, &cell);
+    STATS_ADD(search->stats, placements, -grid->empty_cells);
+    if (!solvable) {
+        STATS_ADD(search->stats, backtracks, 1);
+        return;
+    }
+
+    if (cell == -1) {
+        STATS_SOLUTION(search->stats);
+        if (search->solution_count == 0)
+            for (int row = 0; row < SUDOKU_SIZE; row++)
+                memcpy(search->hexadoku[row], &grid->cells[row * SUDOKU_SIZE],
+                       SUDOKU_SIZE);
+        search->solution_count++;
+        return;
+    }
+
+    DigitMask candidates = cellCandidates(grid, cell);
+    while (candidates != 0) {
+        int digit = lowestDigit(candidates);
+        candidates &= candidates - 1;
+
+        BitsetGrid* child = gridAt(search, depth + 1);
+        *child            = *grid;
+        placeDigit(child, cell, digit);
+        STATS_ADD(search->stats, placements, 1);
+        STATS_BRANCH(search->stats, depth);
+        searchBitset(search, depth + 1);
+        if (isSolutionLimitReached(search->solution_count,
+                                   search->solution_limit))
+            return;
+    }
+}
+
+int searchSolutionsBitset(uint8_t** hexadoku, int solution_limit,
+                          SearchStats* stats) {
+    BitsetSearch search = {hexadoku, 0, solution_limit, selectCandidateKernel(),
+                           stats, {NULL}};
+
+    BitsetGrid* grid = gridAt(&search, 0);
+    memset(grid, 0, sizeof(BitsetGrid));
+    grid->empty_cells = SUDOKU_SIZE * SUDOKU_SIZE;
+    for (int cell = 0; cell < SUDOKU_SIZE * SUDOKU_SIZE; cell++) {
+        int digit = hexadoku[rowOfCell(cell)][columnOfCell(cell)];
+        if (digit != 0) placeDigit(grid, cell, digit);
+    }
+
+    STATS_RESET(stats);
+    searchBitset(&search, 0);
+    for (int depth = 0; depth < SEARCH_LEVELS && search.grids[depth] != NULL;
+         depth++)
+        free(search.grids[depth]);
+    return search.solution_count;
+}
@@ -0,0 +1,213 @@
+#include "CandidateKernel.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// the vector kernels process whole rows of 16 cells
+#if defined(HAS_X86_KERNELS) && SUDOKU_SIZE == 16
+#define HAS_ROW_KERNELS
+#include <immintrin.h>
+#endif
+
+#define CELL_COUNT (SUDOKU_SIZE * SUDOKU_SIZE)
+
+// Candidates and their counts are folded into one key per cell,
+// count * CELL_COUNT + cell (count << 8 | cell in 16 bits for 16x16 grids),
+// so a plain minimum finds the most constrained cell.
+#define FILLED_CELL_KEY ((SUDOKU_SIZE + 1) * CELL_COUNT)
+
+// Without a popcnt instruction in the baseline ISA, __builtin_popcount is a
+// library call, so count the bits of the 16-bit masks by hand.
+static inline int popcount16(unsigned x) {
+    x = x - ((x >> 1) & 0x5555);
+    x = (x & 0x3333) + ((x >> 2) & 0x3333);
+    x = (x + (x >> 4)) & 0x0F0F;
+    return (x + (x >> 8)) & 0x001F;
+}
+
+static inline int popcountDigits(DigitMask mask) {
+#if SUDOKU_SIZE <= 16
+    return popcount16(mask);
+#else
+    return __builtin_popcountll(mask);
+#endif
+}
+
+int computeCandidatesScalar(const BitsetGrid* grid, DigitMask* candidates,
+                            int* min_count) {
+    int min_key = FILLED_CELL_KEY;
+    for (int cell = 0; cell < CELL_COUNT; cell++) {
+        if (grid->cells[cell] != 0) {
+            candidates[cell] = 0;
+            continue;
+        }
+        candidates[cell] = cellCandidates(grid, cell);
+        int key = popcountDigits(candidates[cell]) * CELL_COUNT + cell;
+        if (key < min_key) min_key = key;
+    }
+    *min_count = min_key / CELL_COUNT;
+    return min_key == FILLED_CELL_KEY ? -1 : min_key % CELL_COUNT;
+}
+
+#ifdef HAS_ROW_KERNELS
+
+// Box masks spread over the columns of a band of rows: box_rows[band][column]
+// is the mask of the box containing that column.
+static void spreadBoxMasks(const BitsetGrid* grid,
+                           DigitMask box_rows[BOX_SIZE][SUDOKU_SIZE]) {
+    for (int band = 0; band < BOX_SIZE; band++)
+        for (int column = 0; column < SUDOKU_SIZE; column++)
+            box_rows[band][column] =
+                grid->boxes[band * BOX_SIZE + column / BOX_SIZE];
+}
+
+__attribute__((target("sse2"))) static inline __m128i popcount16SSE2(
+    __m128i x) {
+    x = _mm_sub_epi16(x, _mm_and_si128(_mm_srli_epi16(x, 1),
+                                       _mm_set1_epi16(0x5555)));
+    x = _mm_add_epi16(_mm_and_si128(x, _mm_set1_epi16(0x3333)),
+                      _mm_and_si128(_mm_srli_epi16(x, 2),
+                                    _mm_set1_epi16(0x3333)));
+    x = _mm_and_si128(_mm_add_epi16(x, _mm_srli_epi16(x, 4)),
+                      _mm_set1_epi16(0x0F0F));
+    return _mm_and_si128(_mm_add_epi16(x, _mm_srli_epi16(x, 8)),
+                         _mm_set1_epi16(0x001F));
+}
+
+// Half a row (8 cells) per iteration.
+__attribute__((target("sse2"))) static int computeCandidatesSSE2(
+    const BitsetGrid* grid, DigitMask* candidates, int* min_count) {
+    DigitMask box_rows[BOX_SIZE][SUDOKU_SIZE];
+    spreadBoxMasks(grid, box_rows);
+
+    const __m128i full     = _mm_set1_epi16((short)FULL_DIGIT_MASK);
+    const __m128i filled   = _mm_set1_epi16(FILLED_CELL_KEY);
+    const __m128i lanes    = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+    __m128i       min_keys = filled;
+
+    for (int row = 0; row < SUDOKU_SIZE; row++) {
+        __m128i row_mask = _mm_set1_epi16((short)grid->rows[row]);
+        __m128i cells = _mm_loadu_si128((const __m128i*)&grid->cells[row * 16]);
+        __m128i empty_bytes = _mm_cmpeq_epi8(cells, _mm_setzero_si128());
+        for (int half = 0; half < 2; half++) {
+            int     column = half * 8;
+            __m128i used   = _mm_or_si128(
+                row_mask,
+                _mm_or_si128(
+                    _mm_loadu_si128((const __m128i*)&grid->columns[column]),
+                    _mm_loadu_si128(
+                        (const __m128i*)&box_rows[row / BOX_SIZE][column])));
+            __m128i empty = half == 0
+                                ? _mm_unpacklo_epi8(empty_bytes, empty_bytes)
+                                : _mm_unpackhi_epi8(empty_bytes, empty_bytes);
+            __m128i cand  = _mm_and_si128(_mm_andnot_si128(used, full), empty);
+            _mm_storeu_si128((__m128i*)&candidates[row * 16 + column], cand);
+
+            __m128i keys = _mm_or_si128(
+                _mm_slli_epi16(popcount16SSE2(cand), 8),
+                _mm_add_epi16(lanes, _mm_set1_epi16(row * 16 + column)));
+            // keys stay below 0x8000, so the signed minimum is fine
+            keys     = _mm_or_si128(_mm_and_si128(empty, keys),
+                                    _mm_andnot_si128(empty, filled));
+            min_keys = _mm_min_epi16(min_keys, keys);
+        }
+    }
+
+    uint16_t keys[8];
+    _mm_storeu_si128((__m128i*)keys, min_keys);
+    int min_key = FILLED_CELL_KEY;
+    for (int i = 0; i < 8; i++)
+        if (keys[i] < min_key) min_key = keys[i];
+    *min_count = min_key >> 8;
+    return min_key == FILLED_CELL_KEY ? -1 : (min_key & 0xFF);
+}
+
+__attribute__((target("avx2"))) static inline __m256i popcount16AVX2(
+    __m256i x) {
+    x = _mm256_sub_epi16(x, _mm256_and_si256(_mm256_srli_epi16(x, 1),
+                                             _mm256_set1_epi16(0x5555)));
+    x = _mm256_add_epi16(_mm256_and_si256(x, _mm256_set1_epi16(0x3333)),
+                         _mm256_and_si256(_mm256_srli_epi16(x, 2),
+                                          _mm256_set1_epi16(0x3333)));
+    x = _mm256_and_si256(_mm256_add_epi16(x, _mm256_srli_epi16(x, 4)),
+                         _mm256_set1_epi16(0x0F0F));
+    return _mm256_and_si256(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)),
+                            _mm256_set1_epi16(0x001F));
+}
+
+// A whole row (16 cells) per iteration.
+__attribute__((target("avx2"))) static int computeCandidatesAVX2(
+    const BitsetGrid* grid, DigitMask* candidates, int* min_count) {
+    DigitMask box_rows[BOX_SIZE][SUDOKU_SIZE];
+    spreadBoxMasks(grid, box_rows);
+
+    const __m256i full    = _mm256_set1_epi16((short)FULL_DIGIT_MASK);
+    const __m256i filled  = _mm256_set1_epi16(FILLED_CELL_KEY);
+    const __m256i columns = _mm256_loadu_si256((const __m256i*)grid->columns);
+    const __m256i lanes   = _mm256_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7, 8, 9,
+                                              10, 11, 12, 13, 14, 15);
+    __m256i       min_keys = filled;
+
+    for (int row = 0; row < SUDOKU_SIZE; row++) {
+        __m256i used = _mm256_or_si256(
+            _mm256_set1_epi16((short)grid->rows[row]),
+            _mm256_or_si256(columns,
+                            _mm256_loadu_si256(
+                                (const __m256i*)box_rows[row / BOX_SIZE])));
+        __m256i cells = _mm256_cvtepu8_epi16(
+            _mm_loadu_si128((const __m128i*)&grid->cells[row * 16]));
+        __m256i empty = _mm256_cmpeq_epi16(cells, _mm256_setzero_si256());
+        __m256i cand  =
+            _mm256_and_si256(_mm256_andnot_si256(used, full), empty);
+        _mm256_storeu_si256((__m256i*)&candidates[row * 16], cand);
+
+        __m256i keys = _mm256_or_si256(
+            _mm256_slli_epi16(popcount16AVX2(cand), 8),
+            _mm256_add_epi16(lanes, _mm256_set1_epi16(row * 16)));
+        keys     = _mm256_blendv_epi8(filled, keys, empty);
+        min_keys = _mm256_min_epu16(min_keys, keys);
+    }
+
+    __m128i halves = _mm_min_epu16(_mm256_castsi256_si128(min_keys),
+                                   _mm256_extracti128_si256(min_keys, 1));
+    // the minimum lands in the lowest lane
+    int min_key = _mm_cvtsi128_si32(_mm_minpos_epu16(halves)) & 0xFFFF;
+    *min_count  = min_key >> 8;
+    return min_key == FILLED_CELL_KEY ? -1 : (min_key & 0xFF);
+}
+
+#endif
+
+static bool isKernelAllowed(const char* name) {
+    const char* forced = getenv("HEXADOKU_SIMD");
+    if (forced == NULL) return true;
+    // an explicit choice allows itself and every narrower implementation
+    const char* order[] = {"scalar", "sse2", "avx2"};
+    int         forced_level = -1;
+    int         level        = -1;
+    for (int i = 0; i < 3; i++) {
+        if (strcmp(forced, order[i]) == 0) forced_level = i;
+        if (strcmp(name, order[i]) == 0) level = i;
+    }
+    return forced_level == -1 || level <= forced_level;
+}
+
+const char* candidateKernelName(void) {
+#ifdef HAS_X86_KERNELS
+    if (__builtin_cpu_supports("avx2") && isKernelAllowed("avx2"))
+        return "avx2";
+    if (__builtin_cpu_supports("sse2") && isKernelAllowed("sse2"))
+        return "sse2";
+#endif
+    return "scalar";
+}
+
+CandidateKernel selectCandidateKernel(void) {
+    const char* name = candidateKernelName();
+#ifdef HAS_ROW_KERNELS
+    if (strcmp(name, "avx2") == 0) return computeCandidatesAVX2;
+    if (strcmp(name, "sse2") == 0) return computeCandidatesSSE2;
+#endif
+    (void)name;
+    return computeCandidatesScalar;
+}
@@ -1,4 +1,4 @@
 #include "Constants.h"
 
-const size_t LINE_WIDTH  = 4 * SUDOKU_SIZE + 1;
-const size_t LINE_HEIGHT = 2 * SUDOKU_SIZE + 1;
+const char DIGIT_SYMBOLS[] =
+    "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789@#";
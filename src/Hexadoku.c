@@ -1,56 +1,56 @@
 #include "Hexadoku.h"
 
+uint8_t** createHexadoku(void) {
+    uint8_t** hexadoku = (uint8_t**)malloc(SUDOKU_SIZE * sizeof(uint8_t*));
+    uint8_t*  cells =
+        (uint8_t*)calloc(SUDOKU_SIZE * SUDOKU_SIZE, sizeof(uint8_t));
+    for (int i = 0; i < SUDOKU_SIZE; i++) hexadoku[i] = cells + i * SUDOKU_SIZE;
+    return hexadoku;
+}
+
+void freeHexadoku(uint8_t** hexadoku) {
+    free(hexadoku[0]);
+    free(hexadoku);
+}
 
+// Single pass over the grid, collecting the digits seen in each row, column
+// and box as bit masks.
 bool isHexadokuValid(uint8_t** hexadoku) {
-    // check rows
+    uint64_t rows[SUDOKU_SIZE]    = {0};
+    uint64_t columns[SUDOKU_SIZE] = {0};
+    uint64_t blocks[SUDOKU_SIZE]  = {0};
+
     for (int i = 0; i < SUDOKU_SIZE; i++) {
-        bool row[SUDOKU_SIZE] = {0};
         for (int j = 0; j < SUDOKU_SIZE; j++) {
             if (hexadoku[i][j] == 0) continue;
-            if (row[hexadoku[i][j] - 1] != false) {
+            uint64_t bit   = 1ull << (hexadoku[i][j] - 1);
+            int      block = i / BOX_SIZE * BOX_SIZE + j / BOX_SIZE;
+            if (rows[i] & bit) {
                 DEBUG_PRINTF("Invalid row %d.\n", i + 1);
                 return false;
             }
-            row[hexadoku[i][j] - 1] = true;
-        }
-    }
-
-    // check columns
-    for (int i = 0; i < SUDOKU_SIZE; i++) {
-        bool column[SUDOKU_SIZE] = {0};
-        for (int j = 0; j < SUDOKU_SIZE; j++) {
-            if (hexadoku[j][i] == 0) continue;
-            if (column[hexadoku[j][i] - 1] != false) {
-                DEBUG_PRINTF("Invalid column %d.\n", i + 1);
+            if (columns[j] & bit) {
+                DEBUG_PRINTF("Invalid column %d.\n", j + 1);
                 return false;
             }
-            column[hexadoku[j][i] - 1] = true;
-        }
-    }
-
-    // check blocks
-    for (int i = 0; i < SUDOKU_SIZE; i++) {
-        bool block[SUDOKU_SIZE] = {0};
-        for (int j = 0; j < SUDOKU_SIZE; j++) {
-            int row    = i / BOX_SIZE * BOX_SIZE + j / BOX_SIZE;
-            int column = i % BOX_SIZE * BOX_SIZE + j % BOX_SIZE;
-            if (hexadoku[row][column] == 0) continue;
-            if (block[hexadoku[row][column] - 1] != false) {
-                DEBUG_PRINTF("Invalid block %d.\n", i + 1);
+            if (blocks[block] & bit) {
+                DEBUG_PRINTF("Invalid block %d.\n", block + 1);
                 return false;
             }
-            block[hexadoku[row][column] - 1] = true;
+            rows[i] |= bit;
+            columns[j] |= bit;
+            blocks[block] |= bit;
         }
     }
 
     return true;
 }
 
-// print 16x16 hexadoku
+// Every cell is 4 characters wide, boxes are framed by '|' and solid lines.
 void printHexadoku(uint8_t** hexadoku) {
     // print first line
     for (size_t i = 0; i < LINE_WIDTH - 1; i++) {
-        if (i % BOX_SIZE == 0) {
+        if (i % 4 == 0) {
             printf("+");
         } else {
             printf("-");
@@ -61,12 +61,12 @@ void printHexadoku(uint8_t** hexadoku) {
         if (i % 2 == 0) {
             // print line with letters
             for (size_t j = 0; j < LINE_WIDTH - 1; j++) {
-                if (j % 16 == 0) {
+                if (j % (4 * BOX_SIZE) == 0) {
                     printf("|");
                 } else if ((j - 2) % 4 == 0) {
                     // letter position
-                    char letter = hexadoku[i / 2][(j - 2) / 4];
-                    printf("%c", letter == 0 ? ' ' : letter + 'a' - 1);
+                    int digit = hexadoku[i / 2][(j - 2) / 4];
+                    printf("%c", digit == 0 ? ' ' : DIGIT_SYMBOLS[digit - 1]);
                 } else {
                     printf(" ");
                 }
@@ -74,7 +74,7 @@ void printHexadoku(uint8_t** hexadoku) {
             printf("|\n");
         } else {
             // print delimiter line
-            bool is_dashed = (i / 2 + 1) % 4 == 0 ? true : false;
+            bool is_dashed = (i / 2 + 1) % BOX_SIZE == 0 ? true : false;
             for (size_t j = 0; j < LINE_WIDTH; j++) {
                 if (j % 4 == 0) {
                     printf("+");
@@ -86,3 +86,34 @@ void printHexadoku(uint8_t** hexadoku) {
         }
     }
 }
+
+void printHexadokuLine(uint8_t** hexadoku) {
+    char line[SUDOKU_SIZE * SUDOKU_SIZE + 1];
+    for (int cell = 0; cell < SUDOKU_SIZE * SUDOKU_SIZE; cell++) {
+        int digit  = hexadoku[0][cell];
+        line[cell] = digit == 0 ? '.' : DIGIT_SYMBOLS[digit - 1];
+    }
+    line[SUDOKU_SIZE * SUDOKU_SIZE] = '\n';
+    fwrite(line, 1, sizeof(line), stdout);
+}
+
+static void printSolution(uint8_t** hexadoku, PuzzleFormat format) {
+    if (format == FORMAT_LINE)
+        printHexadokuLine(hexadoku);
+    else
+        printHexadoku(hexadoku);
+}
+
+void printSolveResult(uint8_t** hexadoku, int solution_count,
+                      int solution_limit, PuzzleFormat format) {
+    if (isSolutionLimitReached(solution_count, solution_limit)) {
+        printf("Celkem reseni: alespon %d\n", solution_count);
+        if (solution_count == 1) printSolution(hexadoku, format);
+    } else if (solution_count == 0) {
+        printf("Reseni neexistuje.\n");
+    } else if (solution_count == 1) {
+        printSolution(hexadoku, format);
+    } else {
+        printf("Celkem reseni: %d\n", solution_count);
+    }
+}
@@ -4,168 +4,249 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
-uint8_t** readProgtest(void) {
-    uint8_t** hexadoku = (uint8_t**)malloc(16 * sizeof(char*));
+#include "Hexadoku.h"
 
-    // read first line
-    char*     line = getString();
-    if (!isDelimiterStringValid(line, false)) {
-        DEBUG_PRINTF("Invalid first line.\n");
-        free(line);
-        free(hexadoku);
-        return NULL;
-    }
+// Bytes read from the stream at once, the buffer grows if a line is longer.
+#define READ_BLOCK_SIZE (1 << 16)
 
-    // read line with letters and delimiter lines
-    for (size_t i = 0; i < LINE_HEIGHT - 2; i++) {
-        free(line);
-        if (i % 2 == 0) {
-            // read line with letters
-            line            = getString();
-            hexadoku[i / 2] = strToUint8t(line);
-            if (hexadoku[i / 2] == NULL) {
-                DEBUG_PRINTF("Invalid line %zu.\n", i / 2 + 1);
-                free(line);
-                for (size_t j = 0; j <= i / 2; j++) free(hexadoku[j]);
-                free(hexadoku);
-                return NULL;
-            }
-        } else {
-            // read delimiter line
-            line           = getString();
-            bool is_dashed = (i / 2 + 1) % 4 == 0 ? false : true;
-            if (!isDelimiterStringValid(line, is_dashed)) {
-                DEBUG_PRINTF("Invalid delimiter line %zu.\n", i / 2 + 1);
-                free(line);
-                for (size_t j = 0; j <= i / 2; j++) free(hexadoku[j]);
-                free(hexadoku);
-                return NULL;
-            }
-        }
+#define INVALID_DIGIT 0xFF
+
+PuzzleReader* createPuzzleReader(FILE* stream) {
+    PuzzleReader* reader = (PuzzleReader*)malloc(sizeof(PuzzleReader));
+    reader->stream       = stream;
+    reader->capacity     = READ_BLOCK_SIZE;
+    reader->buffer       = (char*)malloc(reader->capacity);
+    reader->start        = 0;
+    reader->end          = 0;
+    reader->eof          = false;
+    reader->interactive  = isatty(fileno(stream));
+
+    for (size_t i = 0; i < LINE_WIDTH; i++) {
+        bool is_corner         = i % 4 == 0;
+        reader->solid[i]       = is_corner ? '+' : '-';
+        reader->dashed[i]      = is_corner ? '+' : ' ';
+        reader->letters[i]     = i % (4 * BOX_SIZE) == 0 ? '|' : ' ';
+        reader->letter_mask[i] = i % 4 == 2 ? 0 : 0xFF;
     }
-    free(line);
-
-    // read last line
-    line = getString();
-    if (!isDelimiterStringValid(line, false)) {
-        DEBUG_PRINTF("Invalid last line.\n");
-        free(line);
-        for (int j = 0; j < 16; j++) free(hexadoku[j]);
-        free(hexadoku);
-        return NULL;
+    memset(reader->digits, INVALID_DIGIT, sizeof(reader->digits));
+    memset(reader->line_digits, INVALID_DIGIT, sizeof(reader->line_digits));
+    reader->digits[(uint8_t)' ']      = 0;
+    reader->line_digits[(uint8_t)'.'] = 0;
+    // blank unless it is a digit, as in 64x64 grids
+    reader->line_digits[(uint8_t)'0'] = 0;
+    for (int digit = 1; digit <= SUDOKU_SIZE; digit++) {
+        uint8_t symbol              = (uint8_t)DIGIT_SYMBOLS[digit - 1];
+        reader->digits[symbol]      = (uint8_t)digit;
+        reader->line_digits[symbol] = (uint8_t)digit;
     }
-    free(line);
+#if SUDOKU_SIZE <= 26
+    // Line corpora mostly write 1 to 9 and then A, B, ..., 1-9A-G for 16x16
+    // grids. The letters of these sizes are lowercase, so both are accepted.
+    for (int digit = 1; digit <= SUDOKU_SIZE; digit++) {
+        char symbol =
+            digit <= 9 ? (char)('0' + digit) : (char)('A' + digit - 10);
+        reader->line_digits[(uint8_t)symbol] = (uint8_t)digit;
+    }
+#endif
 
-    // check no characters are left in stdin
-    line = getString();
-    if (strlen(line) != 0) {
-        DEBUG_PRINTF("Input after hexadoku.\n");
-        free(line);
-        for (int j = 0; j < 16; j++) free(hexadoku[j]);
-        free(hexadoku);
-        return NULL;
+    return reader;
+}
+
+void freePuzzleReader(PuzzleReader* reader) {
+    free(reader->buffer);
+    free(reader);
+}
+
+// Move the bytes not consumed yet to the front of the buffer, growing it if
+// they fill it, and append what the stream has next: a whole block, or the
+// next line typed on a terminal so that the reader does not wait for more.
+static void fillBuffer(PuzzleReader* reader) {
+    size_t pending = reader->end - reader->start;
+    memmove(reader->buffer, reader->buffer + reader->start, pending);
+    reader->start = 0;
+    reader->end   = pending;
+    if (reader->capacity - pending < 2) {
+        reader->capacity *= 2;
+        reader->buffer = (char*)realloc(reader->buffer, reader->capacity);
     }
-    free(line);
 
-    return hexadoku;
+    char*  free_space = reader->buffer + pending;
+    size_t space      = reader->capacity - pending;
+    size_t read       = 0;
+    if (!reader->interactive)
+        read = fread(free_space, 1, space, reader->stream);
+    else if (fgets(free_space, (int)space, reader->stream) != NULL)
+        read = strlen(free_space);
+
+    reader->end += read;
+    if (read == 0) reader->eof = true;
 }
 
-bool isDelimiterStringValid(char* string, bool is_dashed) {
-    size_t line_width = (int)SUDOKU_SIZE * 4 + 1;
-    if (strlen(string) != line_width) {
-        DEBUG_PRINTF("Invalid line width.\n");
-        DEBUG_PRINTF("Expected: %zu, got: %zu\n", line_width, strlen(string));
-        return false;
+// Next line of the stream, in place in the buffer and valid until the next
+// call. The length excludes the newline and trailing whitespace. at_end is set
+// if the line was ended by the end of the stream rather than a newline, which
+// includes an empty line past the end.
+static const char* nextLine(PuzzleReader* reader, size_t* length,
+                            bool* at_end) {
+    size_t      scanned = 0;  // bytes from start known to hold no newline
+    const char* newline;
+    for (;;) {
+        newline = (const char*)memchr(reader->buffer + reader->start + scanned,
+                                      '\n',
+                                      reader->end - reader->start - scanned);
+        if (newline != NULL || reader->eof) break;
+        scanned = reader->end - reader->start;
+        fillBuffer(reader);
     }
 
-    if (is_dashed) {
-        for (size_t i = 0; i < line_width; i++) {
-            if (i % 4 == 0 && string[i] != '+') {
-                DEBUG_PRINTF("Invalid character at position %zu.\n", i);
-                DEBUG_PRINTF("Expected: '+', got: '%c'\n", string[i]);
-                return false;
-            } else if (i % 4 && string[i] != ' ') {
-                DEBUG_PRINTF("Invalid character at position %zu.\n", i);
-                DEBUG_PRINTF("Expected: ' ', got: '%c'\n", string[i]);
-                return false;
-            }
-        }
-    } else {
-        for (size_t i = 0; i < line_width; i++) {
-            if (i % 4 == 0 && string[i] != '+') {
-                DEBUG_PRINTF("Invalid character at position %zu.\n", i);
-                DEBUG_PRINTF("Expected: '+', got: '%c'\n", string[i]);
-                return false;
-            } else if (i % 4 && string[i] != '-') {
-                DEBUG_PRINTF("Invalid character at position %zu.\n", i);
-                DEBUG_PRINTF("Expected: '-', got: '%c'\n", string[i]);
-                return false;
-            }
-        }
+    const char* line = reader->buffer + reader->start;
+    const char* end  = newline != NULL ? newline : reader->buffer + reader->end;
+    size_t      size = (size_t)(end - line);
+    reader->start += newline != NULL ? size + 1 : size;
+    *at_end = newline == NULL;
+
+    while (size > 0 && isspace((unsigned char)line[size - 1])) size--;
+    *length = size;
+    return line;
+}
+
+static bool isDelimiterLine(const char* line, size_t length,
+                            const char* expected) {
+    return length == LINE_WIDTH && memcmp(line, expected, LINE_WIDTH) == 0;
+}
+
+// Whether the line equals the expected one in every byte the mask keeps,
+// compared a word at a time.
+static bool matchesMasked(const char* line, const char* expected,
+                          const uint8_t* mask) {
+    uint64_t difference = 0;
+    size_t   i          = 0;
+    for (; i + sizeof(uint64_t) <= LINE_WIDTH; i += sizeof(uint64_t)) {
+        uint64_t word, expected_word, mask_word;
+        memcpy(&word, line + i, sizeof(uint64_t));
+        memcpy(&expected_word, expected + i, sizeof(uint64_t));
+        memcpy(&mask_word, mask + i, sizeof(uint64_t));
+        difference |= (word ^ expected_word) & mask_word;
     }
-    return true;
+    for (; i < LINE_WIDTH; i++)
+        difference |= (uint8_t)(line[i] ^ expected[i]) & mask[i];
+    return difference == 0;
 }
 
-bool isLetterValid(char a) {
-    if ((a >= 'a') && (a <= 'a' + SUDOKU_SIZE - 1)) return true;
-    if (a == ' ') return true;
-    return false;
+// Decode count cells lying stride bytes apart through a digit table.
+// @return false if some byte is neither a digit nor blank.
+static bool decodeCells(const uint8_t table[256], const char* chars,
+                        size_t stride, int count, uint8_t* cells) {
+    uint8_t invalid = 0;
+    for (int i = 0; i < count; i++) {
+        uint8_t digit = table[(uint8_t)chars[i * stride]];
+        cells[i]      = digit;
+        invalid |= digit & 0x80;
+    }
+    return invalid == 0;
 }
 
-uint8_t* strToUint8t(char* string) {
-    if (strlen(string) != LINE_WIDTH) {
-        DEBUG_PRINTF("Invalid line width.\n");
+// Decode a line of letters into a row of digits, 0 for a blank cell.
+// @return false if the line is malformed.
+static bool decodeLetters(const PuzzleReader* reader, const char* line,
+                          size_t length, uint8_t* row) {
+    return length == LINE_WIDTH &&
+           matchesMasked(line, reader->letters, reader->letter_mask) &&
+           decodeCells(reader->digits, line + 2, 4, SUDOKU_SIZE, row);
+}
+
+// First line of a record, skipping separators between records if allowed.
+static const char* firstLine(PuzzleReader* reader, bool skip_blank_lines,
+                             size_t* length, bool* at_end) {
+    const char* line = nextLine(reader, length, at_end);
+    while (skip_blank_lines && *length == 0 && !*at_end)
+        line = nextLine(reader, length, at_end);
+    return line;
+}
+
+uint8_t** readPuzzle(PuzzleFormat format) {
+    PuzzleReader* reader   = createPuzzleReader(stdin);
+    uint8_t**     hexadoku = createHexadoku();
+    bool          is_valid =
+        readPuzzleRecord(reader, format, hexadoku, false) == READ_OK;
+
+    // check no characters are left in stdin
+    if (is_valid) {
+        size_t length;
+        bool   at_end;
+        nextLine(reader, &length, &at_end);
+        if (length != 0) {
+            DEBUG_PRINTF("Input after hexadoku.\n");
+            is_valid = false;
+        }
+    }
+    freePuzzleReader(reader);
+
+    if (!is_valid) {
+        freeHexadoku(hexadoku);
         return NULL;
     }
+    return hexadoku;
+}
 
-    uint8_t* array = (uint8_t*)malloc(SUDOKU_SIZE * sizeof(uint8_t));
-    for (size_t i = 0; i < LINE_WIDTH; i++) {
-        if (i % 16 == 0 && string[i] == '|') {
-            continue;
-        } else if ((i - 2) % 4 == 0) {
-            // letter posiition, check if valid,
-            // convert to char and store
-            if (isLetterValid(string[i]))
-                array[(i - 2) / 4] =
-                    (string[i] == ' ') ? 0 : string[i] - 'a' + 1;
-            else {
-                DEBUG_PRINTF("Invalid letter at position %zu.\n", i);
-                free(array);
-                return NULL;
+ReadStatus readPuzzleRecord(PuzzleReader* reader, PuzzleFormat format,
+                            uint8_t** hexadoku, bool skip_blank_lines) {
+    if (format == FORMAT_LINE)
+        return readLineRecord(reader, hexadoku, skip_blank_lines);
+    return readProgtestRecord(reader, hexadoku, skip_blank_lines);
+}
+
+ReadStatus readProgtestRecord(PuzzleReader* reader, uint8_t** hexadoku,
+                              bool skip_blank_lines) {
+    size_t      length;
+    bool        at_end;
+    const char* line = firstLine(reader, skip_blank_lines, &length, &at_end);
+    if (length == 0 && at_end) return READ_EOF;
+
+    // Always consume the whole record, so that the next one starts on its
+    // first line even if this one turns out to be invalid.
+    bool is_valid = isDelimiterLine(line, length, reader->solid);
+    if (!is_valid) DEBUG_PRINTF("Invalid first line.\n");
+
+    // lines of letters alternate with delimiter lines, the last one included
+    uint8_t* cells = hexadoku[0];
+    for (int i = 0; i < 2 * SUDOKU_SIZE; i++) {
+        line = nextLine(reader, &length, &at_end);
+        if (!is_valid) continue;
+        if (i % 2 == 0) {
+            if (!decodeLetters(reader, line, length,
+                               cells + i / 2 * SUDOKU_SIZE)) {
+                DEBUG_PRINTF("Invalid line %d.\n", i / 2 + 1);
+                is_valid = false;
             }
-        } else if (string[i] == ' ' && i % 16 != 0) {
-            continue;
         } else {
-            DEBUG_PRINTF("Invalid character at position %zu.\n", i);
-            free(array);
-            return NULL;
+            bool is_dashed = (i / 2 + 1) % BOX_SIZE != 0;
+            if (!isDelimiterLine(line, length,
+                                 is_dashed ? reader->dashed : reader->solid)) {
+                DEBUG_PRINTF("Invalid delimiter line %d.\n", i / 2 + 1);
+                is_valid = false;
+            }
         }
     }
 
-    return array;
+    return is_valid ? READ_OK : READ_INVALID;
 }
 
-void stripString(char* string) {
-    int len = strlen(string);
-    while (len > 0 && isspace(string[len - 1])) {
-        string[len - 1] = '\0';
-        len--;
-    }
-}
+ReadStatus readLineRecord(PuzzleReader* reader, uint8_t** hexadoku,
+                          bool skip_blank_lines) {
+    size_t      length;
+    bool        at_end;
+    const char* line = firstLine(reader, skip_blank_lines, &length, &at_end);
+    if (length == 0 && at_end) return READ_EOF;
 
-char* getString(void) {
-    char*  string = NULL;
-    size_t size   = 0;
-    if (getline(&string, &size, stdin) == -1) {
-        free(string);
-        string    = (char*)malloc(sizeof(char));
-        string[0] = '\0';
+    if (length != SUDOKU_SIZE * SUDOKU_SIZE) {
+        DEBUG_PRINTF("Invalid line width.\n");
+        return READ_INVALID;
     }
-
-    int len = strlen(string);
-    if (len > 0 && string[len - 1] == '\n') string[len - 1] = '\0';
-    stripString(string);
-
-    return string;
+    return decodeCells(reader->line_digits, line, 1, SUDOKU_SIZE * SUDOKU_SIZE,
+                       hexadoku[0])
+               ? READ_OK
+               : READ_INVALID;
 }
@@ -0,0 +1,238 @@
+#include "LockstepSolver.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "BitsetSolver.h"
+#include "CandidateKernel.h"
+
+#define ALWAYS_INLINE inline __attribute__((always_inline))
+
+// Lane vectors are only returned from functions inlined into the kernels, so
+// the ABI warning of GCC about 32-byte vectors without AVX does not apply.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+// One mask per lane. GCC and clang vector types map every operation to a
+// whole vector of lanes: one AVX2 register, or two SSE2 ones in the baseline
+// build. Comparisons give all ones in the lanes where they hold.
+typedef DigitMask LaneMasks
+    __attribute__((vector_size(LOCKSTEP_LANES * sizeof(DigitMask))));
+
+typedef struct LockstepGrid {
+    LaneMasks cells[SUDOKU_SIZE * SUDOKU_SIZE];  // digit bit, 0 if empty
+    LaneMasks rows[SUDOKU_SIZE];                 // digits placed in each row
+    LaneMasks columns[SUDOKU_SIZE];              // ... in each column
+    LaneMasks boxes[SUDOKU_SIZE];                // ... in each box
+    LaneMasks dead;  // all ones once the lane has a contradiction
+} LockstepGrid;
+
+typedef void (*PropagateKernel)(LockstepGrid* grid);
+
+static inline LaneMasks* unitMasks(LockstepGrid* grid, int unit) {
+    int index = unit % SUDOKU_SIZE;
+    switch (unit / SUDOKU_SIZE) {
+        case 0:
+            return &grid->rows[index];
+        case 1:
+            return &grid->columns[index];
+        default:
+            return &grid->boxes[index];
+    }
+}
+
+static ALWAYS_INLINE bool anyLane(const LaneMasks* masks) {
+    DigitMask any = 0;
+    for (int lane = 0; lane < LOCKSTEP_LANES; lane++) any |= (*masks)[lane];
+    return any != 0;
+}
+
+// Lanes where the mask has at most one bit.
+static ALWAYS_INLINE LaneMasks atMostOneBit(const LaneMasks* masks) {
+    return (LaneMasks)((*masks & (*masks - 1)) == 0);
+}
+
+static ALWAYS_INLINE LaneMasks laneCandidates(const LockstepGrid* grid,
+                                              int cell) {
+    LaneMasks used = grid->rows[rowOfCell(cell)] |
+                     grid->columns[columnOfCell(cell)] |
+                     grid->boxes[boxOfCell(cell)];
+    return ~used & FULL_DIGIT_MASK & (LaneMasks)(grid->cells[cell] == 0);
+}
+
+// Place the digit bits into the cell, lanes with no bit are left alone.
+static ALWAYS_INLINE void placeDigits(LockstepGrid* grid, int cell,
+                                      const LaneMasks* digits) {
+    grid->cells[cell] |= *digits;
+    grid->rows[rowOfCell(cell)] |= *digits;
+    grid->columns[columnOfCell(cell)] |= *digits;
+    grid->boxes[boxOfCell(cell)] |= *digits;
+}
+
+// Place every cell with a single candidate, in cell order.
+static ALWAYS_INLINE bool placeNakedSingles(LockstepGrid* grid) {
+    LaneMasks changed = {0};
+    for (int cell = 0; cell < SUDOKU_SIZE * SUDOKU_SIZE; cell++) {
+        LaneMasks candidates = laneCandidates(grid, cell);
+        LaneMasks empty      = (LaneMasks)(grid->cells[cell] == 0);
+        grid->dead |= empty & (LaneMasks)(candidates == 0);
+        LaneMasks singles = candidates & atMostOneBit(&candidates);
+        placeDigits(grid, cell, &singles);
+        changed |= singles;
+    }
+    return anyLane(&changed);
+}
+
+// Place every digit that fits into a single cell of some unit. As in the
+// bitset engine the digits seen once and at least twice are tracked per unit,
+// and a cell found for two digits at once is a contradiction.
+static ALWAYS_INLINE bool placeHiddenSingles(LockstepGrid* grid) {
+    LaneMasks changed = {0};
+    for (int unit = 0; unit < 3 * SUDOKU_SIZE; unit++) {
+        LaneMasks once  = {0};
+        LaneMasks twice = {0};
+        for (int i = 0; i < SUDOKU_SIZE; i++) {
+            LaneMasks candidates = laneCandidates(grid, unitCell(unit, i));
+            twice |= once & candidates;
+            once |= candidates;
+        }
+
+        LaneMasks placed = *unitMasks(grid, unit);
+        // some digit can not be placed anywhere in this unit
+        grid->dead |= (LaneMasks)((once | placed) != FULL_DIGIT_MASK);
+        LaneMasks hidden = once & ~twice & ~placed;
+        if (!anyLane(&hidden)) continue;
+
+        for (int i = 0; i < SUDOKU_SIZE; i++) {
+            int       cell   = unitCell(unit, i);
+            LaneMasks digits = hidden & laneCandidates(grid, cell);
+            LaneMasks single = atMostOneBit(&digits);
+            grid->dead |= ~single;
+            digits &= single;
+            placeDigits(grid, cell, &digits);
+            changed |= digits;
+        }
+    }
+    return anyLane(&changed);
+}
+
+// Place naked singles, and hidden singles once no lane has a naked single,
+// until no lane changes. The last round runs both passes over the final grid,
+// so the contradictions of every lane have been detected.
+static ALWAYS_INLINE void propagateLanes(LockstepGrid* grid) {
+    bool changed;
+    do {
+        changed = placeNakedSingles(grid) || placeHiddenSingles(grid);
+    } while (changed);
+}
+
+static void propagateBaseline(LockstepGrid* grid) { propagateLanes(grid); }
+
+#ifdef HAS_X86_KERNELS
+__attribute__((target("avx2"))) static void propagateAVX2(
+    LockstepGrid* grid) {
+    propagateLanes(grid);
+}
+#endif
+
+static PropagateKernel selectPropagateKernel(void) {
+#ifdef HAS_X86_KERNELS
+    if (strcmp(candidateKernelName(), "avx2") == 0) return propagateAVX2;
+#endif
+    return propagateBaseline;
+}
+
+// @return The number of empty cells of the hexadoku.
+static int loadLane(LockstepGrid* grid, int lane, uint8_t** hexadoku) {
+    int empty_cells = 0;
+    for (int cell = 0; cell < SUDOKU_SIZE * SUDOKU_SIZE; cell++) {
+        int digit = hexadoku[rowOfCell(cell)][columnOfCell(cell)];
+        empty_cells += digit == 0;
+        if (digit == 0) continue;
+        DigitMask bit           = DIGIT_BIT(digit);
+        grid->cells[cell][lane] = bit;
+        grid->rows[rowOfCell(cell)][lane] |= bit;
+        grid->columns[columnOfCell(cell)][lane] |= bit;
+        grid->boxes[boxOfCell(cell)][lane] |= bit;
+    }
+    return empty_cells;
+}
+
+// Write the digits of the lane into the hexadoku.
+// @return The number of empty cells left.
+static int storeLane(const LockstepGrid* grid, int lane, uint8_t** hexadoku) {
+    int empty_cells = 0;
+    for (int cell = 0; cell < SUDOKU_SIZE * SUDOKU_SIZE; cell++) {
+        DigitMask bit = grid->cells[cell][lane];
+        hexadoku[rowOfCell(cell)][columnOfCell(cell)] =
+            bit == 0 ? 0 : lowestDigit(bit);
+        empty_cells += bit == 0;
+    }
+    return empty_cells;
+}
+
+// Add the counters of the bitset search of a lane to those of the batch. The
+// time to the first solution is measured from the start of the batch.
+static void addLaneStats(SearchStats* stats, const SearchStats* lane_stats) {
+#ifdef SEARCH_STATS
+    stats->nodes += lane_stats->nodes;
+    stats->placements += lane_stats->placements;
+    stats->backtracks += lane_stats->backtracks;
+    for (int depth = 0; depth <= STATS_MAX_DEPTH; depth++) {
+        stats->depth_nodes[depth] += lane_stats->depth_nodes[depth];
+        stats->depth_branches[depth] += lane_stats->depth_branches[depth];
+    }
+    if (stats->first_solution_ns == 0 && lane_stats->first_solution_ns != 0)
+        stats->first_solution_ns = lane_stats->start_ns +
+                                   lane_stats->first_solution_ns -
+                                   stats->start_ns;
+#else
+    (void)stats;
+    (void)lane_stats;
+#endif
+}
+
+void solveLockstep(uint8_t** puzzles[], int count, int solution_limit,
+                   int solution_counts[], SearchStats* stats) {
+    // 512 KB for 64x64 grids, too much for the stack of a batch thread. The
+    // baseline build only aligns the lane vectors to 16 bytes, while the AVX2
+    // kernel loads them as aligned 32-byte vectors, so align to a cache line.
+    size_t        size = (sizeof(LockstepGrid) + 63) / 64 * 64;
+    LockstepGrid* grid = (LockstepGrid*)aligned_alloc(64, size);
+    memset(grid, 0, sizeof(LockstepGrid));
+    STATS_RESET(stats);
+    // unused lanes stay empty grids, where nothing can be placed
+    int empty_cells[LOCKSTEP_LANES];
+    for (int lane = 0; lane < count; lane++)
+        empty_cells[lane] = loadLane(grid, lane, puzzles[lane]);
+
+    selectPropagateKernel()(grid);
+
+    for (int lane = 0; lane < count; lane++) {
+        if (grid->dead[lane] != 0) {
+            // the propagation is the root node of the lane
+            STATS_VISIT(stats, 0);
+            STATS_ADD(stats, backtracks, 1);
+            solution_counts[lane] = 0;
+            continue;
+        }
+        // propagation only places forced digits, so the solutions of the
+        // propagated grid are those of the puzzle
+        int left = storeLane(grid, lane, puzzles[lane]);
+        STATS_ADD(stats, placements, empty_cells[lane] - left);
+        if (left == 0) {
+            STATS_VISIT(stats, 0);
+            STATS_SOLUTION(stats);
+            solution_counts[lane] = 1;
+            continue;
+        }
+        // the bitset search counts the propagated grid as its root
+        SearchStats lane_stats;
+        solution_counts[lane] =
+            searchSolutionsBitset(puzzles[lane], solution_limit, &lane_stats);
+        addLaneStats(stats, &lane_stats);
+    }
+    free(grid);
+}
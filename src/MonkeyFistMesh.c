@@ -1,195 +1,299 @@
 #include "MonkeyFistMesh.h"
 
-Node* createDLXMesh(uint8_t** hexadoku) {
-    DEBUG_PRINTF("In function createDLXMesh()\n");
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "Solver.h"
+
+NodeIndex meshRowNode(const Mesh* mesh, int row_index) {
+    return mesh->row_nodes[row_index];
+}
+
+// Rows of every constraint of the empty grid in ascending order, derived from
+// rowConstraints once per process.
+static ColumnRows     column_rows[MESH_WIDTH];
+static pthread_once_t column_rows_once = PTHREAD_ONCE_INIT;
 
-    Node*  head           = initNode(-1, -1);
-    Node** column_headers = (Node**)malloc(MESH_WIDTH * sizeof(Node*));
+static void initColumnRows(void) {
+    int size[MESH_WIDTH] = {0};
+    for (int row_index = 0; row_index < MESH_ROWS; row_index++) {
+        int constraints[CONSTRAINTS];
+        rowConstraints(row_index, constraints);
+        for (int i = 0; i < CONSTRAINTS; i++) {
+            int constraint = constraints[i];
+            column_rows[constraint][size[constraint]++] = row_index;
+        }
+    }
+}
 
-    for (int i = 0; i < MESH_WIDTH; i++) {
-        Node* column_node = initNode(-1, i);
+const ColumnRows* emptyGridColumnRows(void) {
+    pthread_once(&column_rows_once, initColumnRows);
+    return (const ColumnRows*)column_rows;
+}
 
-        // link with left neighbor, link left neighbor with this node
-        column_node->left        = i ? column_headers[i - 1] : head;
-        column_node->left->right = column_node;
+// Every dropped row changes the row count of CONSTRAINTS - 1 constraints.
+#define PRESOLVE_MAX_CHANGES (MESH_WIDTH + MESH_ROWS * (CONSTRAINTS - 1))
 
-        // set column pointer
-        column_node->column_header = column_node;
+// Constraints satisfied by the hints, rows dropped because they share one
+// with a hint, and when the row count of each constraint last changed.
+typedef struct Presolve {
+    bool      satisfied[MESH_WIDTH];
+    uint64_t  dropped[(MESH_ROWS + 63) / 64];
+    int       clock;
+    int       changed_at[MESH_WIDTH];
+} Presolve;
 
-        // set node count
-        column_node->nodeCount = 0;
+static inline bool isRowDropped(const Presolve* presolve, int row_index) {
+    return presolve->dropped[row_index / 64] >> (row_index % 64) & 1;
+}
 
-        // set up and down pointers (try to delete later)
-        column_node->up   = column_node;
-        column_node->down = column_node;
+static inline void touchConstraint(Presolve* presolve, int constraint) {
+    presolve->changed_at[constraint] = presolve->clock++;
+}
 
-        // add to column headers array
-        column_headers[i] = column_node;
-    }
+// Satisfy a constraint and drop its rows, like cover() would on the mesh of
+// the empty grid. The other constraints of every dropped row lose a row.
+static void satisfyConstraint(Presolve* presolve, int constraint) {
+    presolve->satisfied[constraint] = true;
+    for (int i = 0; i < MAX_COLUMN_SIZE; i++) {
+        int row_index = column_rows[constraint][i];
+        if (isRowDropped(presolve, row_index)) continue;
+        presolve->dropped[row_index / 64] |= 1ull << (row_index % 64);
 
-    // link last column node with head node, first one is already linked
-    column_headers[MESH_WIDTH - 1]->right = head;
-    head->left                            = column_headers[MESH_WIDTH - 1];
-
-    // create mesh nodes using pregenerated exact cover matrix
-    // create first node manually
-    // find first node allowed by clues
-    int pregen_ind = 0;
-
-    for (pregen_ind = 0; pregen_ind < COORDS_ARRAY_SIZE; pregen_ind++) {
-        int hex_row_index =
-            COORDS_ARRAY[pregen_ind][0] / (SUDOKU_SIZE * SUDOKU_SIZE);
-        int hex_col_index =
-            COORDS_ARRAY[pregen_ind][0] / SUDOKU_SIZE % SUDOKU_SIZE;
-        int digit = COORDS_ARRAY[pregen_ind][0] % SUDOKU_SIZE + 1;
-
-        if (hexadoku[hex_row_index][hex_col_index] == 0 ||
-            hexadoku[hex_row_index][hex_col_index] == digit)
-            break;
+        int constraints[CONSTRAINTS];
+        rowConstraints(row_index, constraints);
+        int position = 0;
+        while (constraints[position] != constraint) position++;
+        for (int j = 1; j < CONSTRAINTS; j++)
+            touchConstraint(presolve,
+                            constraints[(position + j) % CONSTRAINTS]);
     }
+}
+
+// Place every hint: satisfy its constraints and drop the rows conflicting
+// with it, i.e. the other digits of its cell and its digit in the same row,
+// column and box. The hints are replayed in the order the solver used to
+// select them on a full mesh, so the change times order the size buckets of
+// the compacted mesh exactly as that mesh would have been left.
+static void presolveHints(Presolve* presolve, uint8_t** hexadoku) {
+    memset(presolve->satisfied, 0, sizeof(presolve->satisfied));
+    memset(presolve->dropped, 0, sizeof(presolve->dropped));
+    // the empty grid's buckets list higher constraints first
+    presolve->clock = 0;
+    for (int constraint = 0; constraint < MESH_WIDTH; constraint++)
+        touchConstraint(presolve, constraint);
+
+    for (int row = 0; row < SUDOKU_SIZE; row++) {
+        for (int column = 0; column < SUDOKU_SIZE; column++) {
+            int digit = hexadoku[row][column];
+            if (digit == 0) continue;
 
-    Node* node =
-        initNode(COORDS_ARRAY[pregen_ind][0], COORDS_ARRAY[pregen_ind][1]);
-    node->left                = node;
-    node->right               = node;
-    node->column_header       = column_headers[node->column_ID];
-    node->up                  = column_headers[node->column_ID];
-    node->down                = column_headers[node->column_ID];
-    node->column_header->up   = node;
-    node->column_header->down = node;
-    node->column_header->nodeCount++;
-    Node* prev_node         = node;
-    Node* first_node_in_row = node;
-    pregen_ind++;
-
-    for (; pregen_ind < COORDS_ARRAY_SIZE; pregen_ind++) {
-        // check that this node is not forbidden by clues
-        // find corresponding hexadoku cell
-        int hex_row_index =
-            COORDS_ARRAY[pregen_ind][0] / (SUDOKU_SIZE * SUDOKU_SIZE);
-        int hex_col_index =
-            COORDS_ARRAY[pregen_ind][0] / SUDOKU_SIZE % SUDOKU_SIZE;
-        int digit = COORDS_ARRAY[pregen_ind][0] % SUDOKU_SIZE + 1;
-
-        if (hexadoku[hex_row_index][hex_col_index] != 0 &&
-            hexadoku[hex_row_index][hex_col_index] != digit)
-            continue;
-
-        // create node
-        int   row_index = COORDS_ARRAY[pregen_ind][0];
-        int   col_index = COORDS_ARRAY[pregen_ind][1];
-
-        Node* node = initNode(row_index, col_index);
-
-        // link node with left neighbor symmetrically
-        if (prev_node->row_ID == row_index) {
-            node->left       = prev_node;
-            prev_node->right = node;
-        } else {
-            // this node is first node in row
-            node->left  = node;
-            node->right = node;
-            // link last and first nodes in previous row
-            prev_node->right        = first_node_in_row;
-            first_node_in_row->left = prev_node;
-            // update first node in row
-            first_node_in_row = node;
+            int row_index =
+                (row * SUDOKU_SIZE + column) * SUDOKU_SIZE + digit - 1;
+            int constraints[CONSTRAINTS];
+            rowConstraints(row_index, constraints);
+            for (int i = 0; i < CONSTRAINTS; i++)
+                satisfyConstraint(presolve, constraints[i]);
         }
+    }
+}
 
-        // link node with top neighbor symmetrically
-        Node* last_node_in_column = column_headers[col_index]->up;
-        node->up                  = last_node_in_column;
-        last_node_in_column->down = node;
+// Order the open constraints by the time their row count last changed, oldest
+// first, with a two pass radix sort. The digits grow with the grid.
+static int sortOpenConstraints(const Presolve* presolve, NodeIndex* order) {
+    enum {
+        RADIX_BITS = PRESOLVE_MAX_CHANGES <= 1 << 14 ? 7
+                     : PRESOLVE_MAX_CHANGES <= 1 << 18 ? 9
+                                                       : 11,
+        RADIX = 1 << RADIX_BITS
+    };
+    _Static_assert(PRESOLVE_MAX_CHANGES <= RADIX * RADIX,
+                   "change times need more radix passes");
 
-        // update column header
-        node->column_header     = column_headers[col_index];
-        node->column_header->up = node;
-        node->down              = node->column_header;
+    NodeIndex scratch[MESH_WIDTH];
+    int       counts[RADIX] = {0};
+    int       size          = 0;
+    for (int constraint = 0; constraint < MESH_WIDTH; constraint++) {
+        if (presolve->satisfied[constraint]) continue;
+        counts[presolve->changed_at[constraint] % RADIX]++;
+        scratch[size++] = constraint;
+    }
+    for (int digit = 0, start = 0; digit < RADIX; digit++) {
+        int count     = counts[digit];
+        counts[digit] = start;
+        start += count;
+    }
+    for (int i = 0; i < size; i++)
+        order[counts[presolve->changed_at[scratch[i]] % RADIX]++] = scratch[i];
 
-        // increment node count of column header
-        node->column_header->nodeCount++;
+    memset(counts, 0, sizeof(counts));
+    for (int i = 0; i < size; i++)
+        counts[presolve->changed_at[order[i]] / RADIX]++;
+    for (int digit = 0, start = 0; digit < RADIX; digit++) {
+        int count     = counts[digit];
+        counts[digit] = start;
+        start += count;
+    }
+    for (int i = 0; i < size; i++)
+        scratch[counts[presolve->changed_at[order[i]] / RADIX]++] = order[i];
 
-        // update pervious row node
-        prev_node = node;
+    memcpy(order, scratch, size * sizeof(NodeIndex));
+    return size;
+}
+
+Mesh* createDLXMesh(uint8_t** hexadoku, Mesh* mesh) {
+    DEBUG_PRINTF("In function createDLXMesh()\n");
+
+    emptyGridColumnRows();
+    if (mesh == NULL) mesh = (Mesh*)malloc(sizeof(Mesh));
+    Node* nodes = mesh->nodes;
+
+    Presolve presolve;
+    presolveHints(&presolve, hexadoku);
+
+    // headers of the open constraints only, numbered densely from 1; uncovered
+    // column headers are linked through their size buckets only
+    NodeIndex header_of[MESH_WIDTH];
+    int       column_count = 0;
+    initNode(&nodes[MESH_HEAD], MESH_HEAD, MESH_HEAD, -1);
+    for (int constraint = 0; constraint < MESH_WIDTH; constraint++) {
+        if (presolve.satisfied[constraint]) continue;
+        NodeIndex header      = ++column_count;
+        header_of[constraint] = header;
+        initNode(&nodes[header], header, header, -1);
+        mesh->node_count[header] = 0;
     }
+    mesh->column_count = column_count;
+    mesh->open_columns = column_count;
 
-    // link first and last nodes in last row
-    prev_node->right        = first_node_in_row;
-    first_node_in_row->left = prev_node;
+    // all size buckets start empty
+    for (int bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+        mesh->bucket_next[BUCKET_SENTINEL(bucket)] = BUCKET_SENTINEL(bucket);
+        mesh->bucket_prev[BUCKET_SENTINEL(bucket)] = BUCKET_SENTINEL(bucket);
+    }
+    mesh->bucket_mask = 0;
 
-    // free column headers array
-    free(column_headers);
+    // create nodes of the live rows from the constraints of each row, nodes
+    // are handed out from the arena in order, which puts the CONSTRAINTS
+    // nodes of every row next to each other
+    NodeIndex next_free = FIRST_ROW_NODE(column_count);
+    memset(mesh->row_nodes, 0, sizeof(mesh->row_nodes));
 
-    return head;
-}
+    for (int row_index = 0; row_index < MESH_ROWS; row_index++) {
+        if (isRowDropped(&presolve, row_index)) continue;
+        mesh->row_nodes[row_index] = next_free;
+
+        int constraints[CONSTRAINTS];
+        rowConstraints(row_index, constraints);
+        for (int i = 0; i < CONSTRAINTS; i++) {
+            NodeIndex header = header_of[constraints[i]];
+            NodeIndex node   = next_free++;
+            nodes[node].column_header = header;
+            nodes[node].row_ID        = row_index;
 
-void printDLXMesh(Node* head) {
-    Node* column_header = head->right;
-    Node* node;
-    while (column_header != head) {
-        printf("Column %d:\n", column_header->column_ID);
-        node = column_header->down;
-        while (node != column_header) {
-            printf("Row %d -> ", node->row_ID);
-            printf("Left %d, Right %d, Up %d, Down %d\n", node->left->column_ID,
-                   node->right->column_ID, node->up->row_ID,
-                   node->down->row_ID);
-            node = node->down;
+            // link node with top neighbor symmetrically
+            NodeIndex last_node_in_column   = nodes[header].up;
+            nodes[node].up                  = last_node_in_column;
+            nodes[last_node_in_column].down = node;
+
+            // update column header
+            nodes[header].up = node;
+            nodes[node].down = header;
+
+            // increment node count of column header
+            mesh->node_count[header]++;
         }
-        column_header = column_header->right;
     }
+
+    // file every column under its final size, the most recently changed
+    // ones first
+    NodeIndex order[MESH_WIDTH];
+    int       open_count = sortOpenConstraints(&presolve, order);
+    for (int i = 0; i < open_count; i++) {
+        NodeIndex header = header_of[order[i]];
+        bucketInsert(mesh, header, mesh->node_count[header]);
+    }
+
+    mesh->size = next_free;
+    STATS_RESET(&mesh->stats);
+    return mesh;
 }
 
-void validateDLXMesh(Node* head) {
-    Node* column_header = head->right;
-    Node* node;
-    while (column_header != head) {
-        if (column_header->nodeCount == 0) {
-            printf("Column %d has no nodes\n", column_header->column_ID);
+void selectRow(Mesh* mesh, NodeIndex row_node) {
+    cover(mesh, mesh->nodes[row_node].column_header);
+    coverRowNeighbors(mesh, row_node);
+}
+
+void deselectRow(Mesh* mesh, NodeIndex row_node) {
+    uncoverRowNeighbors(mesh, row_node);
+    uncover(mesh, mesh->nodes[row_node].column_header);
+}
+
+void printDLXMesh(Mesh* mesh) {
+    Node* nodes = mesh->nodes;
+    for (int bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+        NodeIndex sentinel = BUCKET_SENTINEL(bucket);
+        for (NodeIndex column_header = mesh->bucket_next[sentinel];
+             column_header != sentinel;
+             column_header = mesh->bucket_next[column_header]) {
+            printf("Column %d:\n", column_header - 1);
+            for (NodeIndex node = nodes[column_header].down;
+                 node != column_header; node = nodes[node].down) {
+                printf("Row %d -> ", nodes[node].row_ID);
+                NodeIndex left  = rowNeighbor(node, CONSTRAINTS - 1);
+                NodeIndex right = rowNeighbor(node, 1);
+                printf("Left %d, Right %d, Up %d, Down %d\n",
+                       nodes[left].column_header - 1,
+                       nodes[right].column_header - 1,
+                       nodes[nodes[node].up].row_ID,
+                       nodes[nodes[node].down].row_ID);
+            }
         }
+    }
+}
 
-        for (node = column_header->down; node != column_header;
-             node = node->down) {
-            if (node->left == NULL)
-                printf("Node r%d, c%d has NULL left pointer\n", node->row_ID,
-                       node->column_ID);
-            if (node->right == NULL)
-                printf("Node r%d, c%d has NULL right pointer\n", node->row_ID,
-                       node->column_ID);
-            if (node->up == NULL)
-                printf("Node r%d, c%d has NULL up pointer\n", node->row_ID,
-                       node->column_ID);
-            if (node->down == NULL)
-                printf("Node r%d, c%d has NULL down pointer \n", node->row_ID,
-                       node->column_ID);
-            if (node->column_header == NULL)
-                printf("Node r%d, c%d has NULL column header pointer \n",
-                       node->row_ID, node->column_ID);
+void validateDLXMesh(Mesh* mesh) {
+    Node* nodes = mesh->nodes;
+    for (int bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+        NodeIndex sentinel = BUCKET_SENTINEL(bucket);
+        if (!(mesh->bucket_mask & BUCKET_BIT(bucket)) !=
+            (mesh->bucket_next[sentinel] == sentinel))
+            printf("Bucket %d does not match the bucket mask\n", bucket);
+
+        for (NodeIndex column_header = mesh->bucket_next[sentinel];
+             column_header != sentinel;
+             column_header = mesh->bucket_next[column_header]) {
+            if (BUCKET_OF(mesh->node_count[column_header]) != bucket)
+                printf("Column %d is in bucket %d but has %d nodes\n",
+                       column_header - 1, bucket,
+                       mesh->node_count[column_header]);
+            if (bucket == 0)
+                printf("Column %d has no nodes\n", column_header - 1);
+
+            for (NodeIndex node = nodes[column_header].down;
+                 node != column_header; node = nodes[node].down) {
+                Node* n = &nodes[node];
+                if (node < FIRST_ROW_NODE(mesh->column_count))
+                    printf("Node r%d, c%d is not in a row group\n", n->row_ID,
+                           n->column_header - 1);
+                if (n->up >= mesh->size)
+                    printf("Node r%d, c%d has invalid up link\n", n->row_ID,
+                           n->column_header - 1);
+                if (n->down >= mesh->size)
+                    printf("Node r%d, c%d has invalid down link\n", n->row_ID,
+                           n->column_header - 1);
+                if (n->column_header != column_header)
+                    printf("Node r%d, c%d has invalid column header link\n",
+                           n->row_ID, n->column_header - 1);
+            }
         }
-        column_header = column_header->right;
     }
 
     printf("Validation complete\n");
 }
 
-void freeDLXMesh(Node* head) {
-    Node* column_header = head->right;
-    Node* node;
-    while (column_header != head) {
-        node = column_header->down;
-        while (node != column_header) {
-            Node* next_node = node->down;
-            DEBUG_PRINTF("Freeing node r%d, c%d\n", node->row_ID,
-                         node->column_ID);
-            free(node);
-            node = next_node;
-        }
-
-        Node* next_column_header = column_header->right;
-        DEBUG_PRINTF("Freeing column header c%d\n", column_header->column_ID);
-        free(column_header);
-        column_header = next_column_header;
-    }
-    DEBUG_PRINTF("Freeing head\n");
-    free(head);
+void freeDLXMesh(Mesh* mesh) {
+    DEBUG_PRINTF("Freeing mesh arena\n");
+    free(mesh);
 }
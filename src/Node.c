@@ -1,15 +1,8 @@
 #include "Node.h"
 
-Node* initNode(int rowID, int columnID) {
-    Node* node = (Node*)malloc(sizeof(Node));
-
-    node->left          = node;
-    node->right         = node;
-    node->up            = node;
-    node->down          = node;
-    node->column_header = NULL;
+void initNode(Node* node, NodeIndex index, NodeIndex columnHeader, int rowID) {
+    node->up            = index;
+    node->down          = index;
+    node->column_header = columnHeader;
     node->row_ID        = rowID;
-    node->column_ID     = columnID;
-    node->nodeCount     = 0;
-    return node;
 }
@@ -0,0 +1,181 @@
+#include "Options.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char* ENGINE_NAMES[] = {"dlx", "bitset", "bitcover",
+                                     "lockstep"};
+static const char* FORMAT_NAMES[] = {"progtest", "line"};
+
+// Parse a non-negative solution limit, 0 meaning no limit.
+static bool parseSolutionLimit(const char* string, int* solution_limit) {
+    char* end;
+    long  value = strtol(string, &end, 10);
+    if (*string == '\0' || *end != '\0' || value < 0 || value > INT_MAX)
+        return false;
+    *solution_limit = (int)value;
+    return true;
+}
+
+// Parse an interleave width from 1 to MAX_INTERLEAVE.
+static bool parseInterleave(const char* string, int* interleave) {
+    char* end;
+    long  value = strtol(string, &end, 10);
+    if (*string == '\0' || *end != '\0' || value < 1 ||
+        value > MAX_INTERLEAVE)
+        return false;
+    *interleave = (int)value;
+    return true;
+}
+
+// Parse a transposition table size in megabytes, 0 meaning no table.
+static bool parseTableSize(const char* string, size_t* megabytes) {
+    char* end;
+    long  value = strtol(string, &end, 10);
+    if (*string == '\0' || *end != '\0' || value < 0 || value > 65536)
+        return false;
+    *megabytes = (size_t)value;
+    return true;
+}
+
+// Parse a non-negative thread count, 0 meaning one thread per online CPU.
+static bool parseThreads(const char* string, int* threads) {
+    char* end;
+    long  value = strtol(string, &end, 10);
+    if (*string == '\0' || *end != '\0' || value < 0 || value > 4096)
+        return false;
+    if (value == 0) value = sysconf(_SC_NPROCESSORS_ONLN);
+    *threads = value > 0 ? (int)value : 1;
+    return true;
+}
+
+static bool parseEngine(const char* string, Engine* engine) {
+    for (size_t i = 0; i < sizeof(ENGINE_NAMES) / sizeof(*ENGINE_NAMES); i++) {
+        if (strcmp(string, ENGINE_NAMES[i]) == 0) {
+            *engine = (Engine)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parseFormat(const char* string, PuzzleFormat* format) {
+    for (size_t i = 0; i < sizeof(FORMAT_NAMES) / sizeof(*FORMAT_NAMES); i++) {
+        if (strcmp(string, FORMAT_NAMES[i]) == 0) {
+            *format = (PuzzleFormat)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void defaultOptions(Options* options) {
+    options->batch           = false;
+    options->input_path      = NULL;
+    options->threads         = 1;
+    options->engine          = ENGINE_DLX;
+    options->solution_limit  = 0;
+    options->propagate       = true;
+    options->decompose       = true;
+    options->interleave      = 1;
+    options->table_megabytes = 0;
+    options->format          = FORMAT_PROGTEST;
+}
+
+bool parseOptions(int argc, char** argv, Options* options) {
+    defaultOptions(options);
+
+    int opt;
+    while ((opt = getopt(argc, argv, "bj:e:k:SCi:t:f:h")) != -1) {
+        switch (opt) {
+            case 'b':
+                options->batch = true;
+                break;
+            case 'j':
+                if (!parseThreads(optarg, &options->threads)) {
+                    printUsage(argv[0]);
+                    return false;
+                }
+                break;
+            case 'e':
+                if (!parseEngine(optarg, &options->engine)) {
+                    printUsage(argv[0]);
+                    return false;
+                }
+                break;
+            case 'k':
+                if (!parseSolutionLimit(optarg, &options->solution_limit)) {
+                    printUsage(argv[0]);
+                    return false;
+                }
+                break;
+            case 'S':
+                options->propagate = false;
+                break;
+            case 'C':
+                options->decompose = false;
+                break;
+            case 'i':
+                if (!parseInterleave(optarg, &options->interleave)) {
+                    printUsage(argv[0]);
+                    return false;
+                }
+                break;
+            case 't':
+                if (!parseTableSize(optarg, &options->table_megabytes)) {
+                    printUsage(argv[0]);
+                    return false;
+                }
+                break;
+            case 'f':
+                if (!parseFormat(optarg, &options->format)) {
+                    printUsage(argv[0]);
+                    return false;
+                }
+                break;
+            default:
+                printUsage(argv[0]);
+                return false;
+        }
+    }
+
+    if (optind < argc) options->input_path = argv[optind++];
+    if (optind < argc) {
+        printUsage(argv[0]);
+        return false;
+    }
+    // a single puzzle keeps the interactive Progtest behaviour on stdin
+    if (options->input_path != NULL && !options->batch) {
+        printUsage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+void printUsage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [-b] [-j threads] [-e engine] [-k limit] [-S] [-C] "
+            "[-i searches] [-t megabytes] [-f format] [file]\n"
+            "  (no options)  solve one puzzle from the standard input\n"
+            "  -b            batch mode: solve every puzzle in file (or the\n"
+            "                standard input), one result per puzzle\n"
+            "  -j threads    solving threads, 0 for one per CPU\n"
+            "  -e engine     dlx (default), bitset, bitcover or lockstep\n"
+            "  -k limit      stop after limit solutions, e.g. 2 to only check\n"
+            "                uniqueness (default 0, count all)\n"
+            "  -S            DLX: branch on forced rows one by one instead of\n"
+            "                propagating singles\n"
+            "  -C            DLX: search independent parts of the grid\n"
+            "                together instead of counting them apart\n"
+            "  -i searches   batch DLX: searches each thread interleaves to\n"
+            "                hide memory latency, up to 16 (default 1)\n"
+            "  -t megabytes  DLX: remember subtree solution counts in a table\n"
+            "                of this size per thread (default 0, no table)\n"
+            "  -f format     progtest (default), the bordered grid, or line,\n"
+            "                one puzzle per line, '.' or '0' for blanks and\n"
+            "                the letters or 1-9, A, B, ... as digits\n",
+            program);
+}
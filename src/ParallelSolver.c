@@ -0,0 +1,210 @@
+#include "ParallelSolver.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Hexadoku.h"
+#include "IntVector.h"
+#include "MonkeyFistMesh.h"
+#include "Solver.h"
+
+typedef struct TaskList {
+    IntVector** paths;  // row IDs chosen from the root to each subtree
+    int         size;
+    int         capacity;
+} TaskList;
+
+typedef struct SplitState {
+    TaskList   tasks;
+    IntVector* path;
+    uint8_t**  hexadoku;
+    int        solution_count;  // solutions found above the split depth
+} SplitState;
+
+typedef struct ParallelWorker {
+    TaskList*      tasks;
+    atomic_int*    next;   // index of the next unclaimed task
+    atomic_int*    found;  // solutions of all workers and the split so far
+    const Options* options;
+    uint8_t**      clues;     // the original puzzle, shared read-only
+    uint8_t**      hexadoku;  // private copy, receives the first solution found
+    uint8_t**      scratch;   // hints and the cells written by past tasks
+    int            solution_count;
+    pthread_t      thread;
+} ParallelWorker;
+
+static void pushTask(TaskList* tasks, IntVector* path) {
+    if (tasks->size == tasks->capacity) {
+        tasks->capacity = tasks->capacity == 0 ? 16 : 2 * tasks->capacity;
+        tasks->paths    = (IntVector**)realloc(
+            tasks->paths, tasks->capacity * sizeof(IntVector*));
+    }
+    IntVector* copy = createIntVector(path->size);
+    memcpy(copy->data, path->data, path->size * sizeof(int));
+    copy->size                   = path->size;
+    tasks->paths[tasks->size++] = copy;
+}
+
+static void freeTasks(TaskList* tasks) {
+    for (int i = 0; i < tasks->size; i++) freeIntVector(tasks->paths[i]);
+    free(tasks->paths);
+    tasks->paths    = NULL;
+    tasks->size     = 0;
+    tasks->capacity = 0;
+}
+
+// Same walk as searchSolutions, but stops after the given number of levels
+// that actually branch and records the remaining subtrees as tasks. Forced
+// choices (columns with a single row) do not count towards the depth.
+static void splitSearch(SplitState* state, Mesh* mesh, int depth) {
+    Node* nodes = mesh->nodes;
+    if (mesh->bucket_mask == 0) {
+        if (state->solution_count == 0)
+            solutionToHexadoku(state->path, state->hexadoku);
+        state->solution_count++;
+        return;
+    }
+    if (depth == 0) {
+        pushTask(&state->tasks, state->path);
+        return;
+    }
+
+    NodeIndex column   = getMinColumn(mesh);
+    int       branches = mesh->node_count[column] > 1;
+    cover(mesh, column);
+
+    for (NodeIndex row_node = nodes[column].down; row_node != column;
+         row_node           = nodes[row_node].down) {
+        pushToIntVector(state->path, nodes[row_node].row_ID);
+        coverRowNeighbors(mesh, row_node);
+
+        splitSearch(state, mesh, depth - branches);
+
+        popFromIntVector(state->path);
+        uncoverRowNeighbors(mesh, row_node);
+    }
+
+    uncover(mesh, column);
+}
+
+// Replay the choices of a task. Rows keep their place in the mesh, so they are
+// selected directly, independently of which column the split covered first.
+static void applyPath(Mesh* mesh, IntVector* path) {
+    for (int i = 0; i < path->size; i++)
+        selectRow(mesh, meshRowNode(mesh, path->data[i]));
+}
+
+static void revertPath(Mesh* mesh, IntVector* path) {
+    for (int i = path->size - 1; i >= 0; i--)
+        deselectRow(mesh, meshRowNode(mesh, path->data[i]));
+}
+
+static void* workerLoop(void* arg) {
+    ParallelWorker* worker = (ParallelWorker*)arg;
+    Mesh*           mesh   = createDLXMesh(worker->clues, NULL);
+
+    SolverContext   context;
+    context.solution_limit = worker->options->solution_limit;
+    context.propagate      = worker->options->propagate;
+    context.decompose      = worker->options->decompose;
+    context.table = createTranspositionTable(worker->options->table_megabytes);
+
+    int index;
+    while (!isSolutionLimitReached(atomic_load(worker->found),
+                                   worker->options->solution_limit) &&
+           (index = atomic_fetch_add(worker->next, 1)) < worker->tasks->size) {
+        IntVector* path = worker->tasks->paths[index];
+        // The table key covers every filled cell of the grid it is built
+        // from, so it comes from the clues: the scratch copy keeps the cells
+        // of earlier tasks.
+        resetSolverContext(&context, worker->clues);
+        // A task writes into the scratch copy: the parts of a decomposed node
+        // write their cells even if the task ends up without solutions, and
+        // only a complete solution overwrites every cell without a hint.
+        context.hexadoku = worker->scratch;
+
+        applyPath(mesh, path);
+        // the key covers the hints only, add the columns of the path
+        if (context.table != NULL)
+            for (int i = 0; i < path->size; i++)
+                context.key ^= rowKey(path->data[i]);
+        searchSolutions(&context, mesh);
+        revertPath(mesh, path);
+        // the search only wrote the cells it chose below the task's path
+        if (context.solution_count > 0 && worker->solution_count == 0) {
+            solutionToHexadoku(path, worker->scratch);
+            memcpy(worker->hexadoku[0], worker->scratch[0],
+                   SUDOKU_SIZE * SUDOKU_SIZE);
+        }
+
+        worker->solution_count += context.solution_count;
+        atomic_fetch_add(worker->found, context.solution_count);
+    }
+
+    freeTranspositionTable(context.table);
+    freeDLXMesh(mesh);
+    return NULL;
+}
+
+int searchSolutionsParallel(uint8_t** hexadoku, const Options* options) {
+    int threads        = options->threads;
+    int solution_limit = options->solution_limit;
+
+    // workers need the clues while the split may already write a solution
+    uint8_t** clues = createHexadoku();
+    memcpy(clues[0], hexadoku[0], SUDOKU_SIZE * SUDOKU_SIZE);
+
+    SplitState state  = {{NULL, 0, 0}, createIntVector(0), hexadoku, 0};
+    Mesh*      mesh   = createDLXMesh(clues, NULL);
+    int        target = PARALLEL_TASKS_PER_THREAD * threads;
+    for (int depth = 1; depth <= PARALLEL_MAX_SPLIT_DEPTH; depth++) {
+        freeTasks(&state.tasks);
+        state.solution_count = 0;
+        splitSearch(&state, mesh, depth);
+        if (state.tasks.size == 0 || state.tasks.size >= target) break;
+    }
+    freeDLXMesh(mesh);
+    freeIntVector(state.path);
+
+    atomic_int      next  = 0;
+    atomic_int      found = state.solution_count;
+    ParallelWorker* workers =
+        (ParallelWorker*)malloc(threads * sizeof(ParallelWorker));
+    for (int i = 0; i < threads; i++) {
+        workers[i].tasks          = &state.tasks;
+        workers[i].next           = &next;
+        workers[i].found          = &found;
+        workers[i].options        = options;
+        workers[i].clues          = clues;
+        workers[i].hexadoku       = createHexadoku();
+        workers[i].scratch        = createHexadoku();
+        // solutions only fill the cells without hints
+        memcpy(workers[i].scratch[0], clues[0], SUDOKU_SIZE * SUDOKU_SIZE);
+        workers[i].solution_count = 0;
+        // worker 0 is the calling thread
+        if (i > 0)
+            pthread_create(&workers[i].thread, NULL, workerLoop, &workers[i]);
+    }
+    workerLoop(&workers[0]);
+
+    int solution_count = state.solution_count;
+    for (int i = 0; i < threads; i++) {
+        if (i > 0) pthread_join(workers[i].thread, NULL);
+        if (solution_count == 0 && workers[i].solution_count > 0)
+            memcpy(hexadoku[0], workers[i].hexadoku[0],
+                   SUDOKU_SIZE * SUDOKU_SIZE);
+        solution_count += workers[i].solution_count;
+        freeHexadoku(workers[i].hexadoku);
+        freeHexadoku(workers[i].scratch);
+    }
+
+    free(workers);
+    freeTasks(&state.tasks);
+    freeHexadoku(clues);
+    // threads finishing their subtrees concurrently may overshoot the limit
+    if (isSolutionLimitReached(solution_count, solution_limit))
+        solution_count = solution_limit;
+    return solution_count;
+}
@@ -0,0 +1,49 @@
+#include "PuzzleSolver.h"
+
+#include <string.h>
+
+#include "BitCoverSolver.h"
+#include "BitsetSolver.h"
+#include "LockstepSolver.h"
+
+void initPuzzleSolver(PuzzleSolver* solver, const Options* options) {
+    solver->engine                 = options->engine;
+    solver->mesh                   = NULL;
+    solver->context.solution_limit = options->solution_limit;
+    solver->context.propagate      = options->propagate;
+    solver->context.decompose      = options->decompose;
+    solver->context.table =
+        options->engine == ENGINE_DLX
+            ? createTranspositionTable(options->table_megabytes)
+            : NULL;
+    memset(&solver->stats, 0, sizeof(solver->stats));
+}
+
+int solvePuzzle(PuzzleSolver* solver, uint8_t** hexadoku) {
+    if (solver->engine == ENGINE_BITSET)
+        return searchSolutionsBitset(hexadoku, solver->context.solution_limit,
+                                     &solver->stats);
+    if (solver->engine == ENGINE_BITCOVER)
+        return searchSolutionsBitCover(hexadoku,
+                                       solver->context.solution_limit,
+                                       &solver->stats);
+    if (solver->engine == ENGINE_LOCKSTEP) {
+        int solution_count;
+        solveLockstep(&hexadoku, 1, solver->context.solution_limit,
+                      &solution_count, &solver->stats);
+        return solution_count;
+    }
+
+    solver->mesh = createDLXMesh(hexadoku, solver->mesh);
+    resetSolverContext(&solver->context, hexadoku);
+    searchSolutions(&solver->context, solver->mesh);
+#ifdef SEARCH_STATS
+    solver->stats = solver->mesh->stats;
+#endif
+    return solver->context.solution_count;
+}
+
+void freePuzzleSolver(PuzzleSolver* solver) {
+    if (solver->mesh != NULL) freeDLXMesh(solver->mesh);
+    freeTranspositionTable(solver->context.table);
+}
@@ -0,0 +1,27 @@
+#include "SearchStats.h"
+
+void printSearchStats(FILE* stream, const SearchStats* stats) {
+    fprintf(stream,
+            "nodes: %llu\ncovers: %llu\nuncovers: %llu\nplacements: %llu\n"
+            "dead ends: %llu\nlink updates: %llu\ntable hits: %llu\n"
+            "component splits: %llu\nfirst solution: %llu ns\n",
+            (unsigned long long)stats->nodes,
+            (unsigned long long)stats->covers,
+            (unsigned long long)stats->uncovers,
+            (unsigned long long)stats->placements,
+            (unsigned long long)stats->backtracks,
+            (unsigned long long)stats->link_updates,
+            (unsigned long long)stats->table_hits,
+            (unsigned long long)stats->splits,
+            (unsigned long long)stats->first_solution_ns);
+
+    fprintf(stream, "depth nodes branches branching\n");
+    for (int depth = 0; depth <= STATS_MAX_DEPTH; depth++) {
+        uint64_t nodes    = stats->depth_nodes[depth];
+        uint64_t branches = stats->depth_branches[depth];
+        if (nodes == 0) continue;
+        fprintf(stream, "%5d %llu %llu %.2f\n", depth,
+                (unsigned long long)nodes, (unsigned long long)branches,
+                (double)branches / nodes);
+    }
+}
@@ -1,63 +1,418 @@
 #include "Solver.h"
 
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ExactCover.h"
+#include "Hexadoku.h"
+
+// Components are only looked for in meshes of at most this many open nodes,
+// which the search for them visits. Larger meshes, near the root of a search,
+// were always connected in the puzzles measured.
+#define SPLIT_MAX_NODES 1024
+
 // main solve function and helper functions inspired by
 // https://www.geeksforgeeks.org/implementation-of-exact-cover-problem-and-algorithm-x-using-dlx/
 
-void cover(Node* column_header) {
-    unlinkHorizontal(column_header);
+void resetSolverContext(SolverContext* context, uint8_t** hexadoku) {
+    context->hexadoku       = hexadoku;
+    context->solution_count = 0;
+    context->depth          = 0;
+    context->base_depth     = 0;
+    context->trail_size     = 0;
+    context->key            = 0;
+    if (context->table == NULL) return;
+    for (int row = 0; row < SUDOKU_SIZE; row++)
+        for (int column = 0; column < SUDOKU_SIZE; column++)
+            if (hexadoku[row][column] != 0)
+                context->key ^= rowKey(
+                    (row * SUDOKU_SIZE + column) * SUDOKU_SIZE +
+                    hexadoku[row][column] - 1);
+}
+
+// Track the covered columns in the context's key as a row is selected or
+// deselected.
+static inline void toggleRowKey(SolverContext* context, Mesh* mesh,
+                                NodeIndex row_node) {
+    if (context->table != NULL)
+        context->key ^= rowKey(mesh->nodes[row_node].row_ID);
+}
+
+void solutionToHexadoku(IntVector* solution, uint8_t** hexadoku) {
+    for (int i = 0; i < solution->size; i++) {
+        int row    = rowFromExactCoverIndex(solution->data[i]);
+        int column = columnFromExactCoverIndex(solution->data[i]);
+        int value  = numFromExactCoverIndex(solution->data[i]);
+        hexadoku[row][column] = value;
+    }
+}
+
+static void rowToHexadoku(SolverContext* context, Mesh* mesh,
+                          NodeIndex row_node) {
+    int index = mesh->nodes[row_node].row_ID;
+    context->hexadoku[rowFromExactCoverIndex(index)]
+                     [columnFromExactCoverIndex(index)] =
+        numFromExactCoverIndex(index);
+}
+
+// Write the rows selected on the decision stack and the trail into the
+// hexadoku, if the context has one.
+static void stackToHexadoku(SolverContext* context, Mesh* mesh) {
+    if (context->hexadoku == NULL) return;
+    for (int i = 0; i < context->depth; i++)
+        rowToHexadoku(context, mesh, context->stack[i].row_node);
+    for (int i = 0; i < context->trail_size; i++)
+        rowToHexadoku(context, mesh, context->trail[i]);
+}
+
+// Select the row of every column with a single row, until there is none left
+// or some column has no rows.
+static void propagateSingles(SolverContext* context, Mesh* mesh) {
+    const BucketMask empty  = BUCKET_BIT(0);
+    const BucketMask single = BUCKET_BIT(1);
+    while ((mesh->bucket_mask & (empty | single)) == single) {
+        NodeIndex column = mesh->bucket_next[BUCKET_SENTINEL(1)];
+        NodeIndex row    = mesh->nodes[column].down;
+        selectRow(mesh, row);
+        toggleRowKey(context, mesh, row);
+        context->trail[context->trail_size++] = row;
+        STATS_ADD(&mesh->stats, placements, 1);
+    }
+}
+
+// Deselect the forced rows above the given trail size, last first.
+static void undoTrail(SolverContext* context, Mesh* mesh, int trail_size) {
+    while (context->trail_size > trail_size) {
+        NodeIndex row = context->trail[--context->trail_size];
+        deselectRow(mesh, row);
+        toggleRowKey(context, mesh, row);
+    }
+}
+
+// Bound on the open nodes of a mesh: its open columns times the largest size,
+// one short for the full columns of a 64x64 grid.
+static inline int maxOpenNodes(const Mesh* mesh) {
+    return mesh->open_columns * (63 - __builtin_clzll(mesh->bucket_mask));
+}
+
+// Add the solutions of a subtree counted at once, without going past the
+// solution limit. Counts that do not fit an int saturate.
+static void addSolutions(SolverContext* context, long long solution_count) {
+    long long total = context->solution_count + solution_count;
+    if (context->solution_limit != 0 && total > context->solution_limit)
+        total = context->solution_limit;
+    context->solution_count = total > INT_MAX ? INT_MAX : (int)total;
+}
 
-    for (Node* v_node = column_header->down; v_node != column_header;
-         v_node       = v_node->down) {
-        for (Node* h_node = v_node->right; h_node != v_node;
-             h_node       = h_node->right) {
-            unlinkVertical(h_node);
-            h_node->column_header->nodeCount--;
+// Mark the open columns connected to the start column through shared rows.
+// @return The number of columns written to `component`, the start included.
+static int connectedColumns(const Mesh* mesh, NodeIndex start, bool reached[],
+                            NodeIndex component[]) {
+    const Node* nodes = mesh->nodes;
+    int         size  = 0;
+    reached[start]    = true;
+    component[size++] = start;
+    for (int i = 0; i < size; i++) {
+        NodeIndex column = component[i];
+        for (NodeIndex node = nodes[column].down; node != column;
+             node           = nodes[node].down) {
+            for (int offset = 1; offset < CONSTRAINTS; offset++) {
+                NodeIndex neighbor =
+                    nodes[rowNeighbor(node, offset)].column_header;
+                if (reached[neighbor]) continue;
+                reached[neighbor] = true;
+                component[size++] = neighbor;
+            }
         }
     }
+    return size;
+}
+
+// Count the solutions of the open columns outside `hidden` with a nested
+// search, covering the hidden ones meanwhile. They share no rows with the
+// others, so covering them leaves the rest of the mesh as it is. The levels
+// of the nested search are counted below those of its parent.
+static int countPart(SolverContext* part, const SolverContext* parent,
+                     Mesh* mesh, uint8_t** hexadoku, int solution_limit,
+                     const NodeIndex hidden[], int hidden_size) {
+    for (int i = 0; i < hidden_size; i++) cover(mesh, hidden[i]);
+    part->solution_limit = solution_limit;
+    resetSolverContext(part, hexadoku);
+    part->base_depth = parent->base_depth + parent->depth;
+    searchSolutions(part, mesh);
+    for (int i = hidden_size - 1; i >= 0; i--) uncover(mesh, hidden[i]);
+    return part->solution_count;
+}
+
+// If the open columns fall apart into groups that share no rows, the
+// solutions of the node are every combination of solutions of the groups.
+// The component of the smallest column and the rest are then counted one
+// after the other by nested searches, and their product added, instead of
+// enumerating the combinations. The rest may split further in its own search.
+// @return false if the columns are all connected, or if there is no memory
+// for the nested searches.
+static bool countComponents(SolverContext* context, Mesh* mesh) {
+    bool*      reached   = context->reached;
+    NodeIndex* component = context->component;
+    NodeIndex* rest      = context->rest;
+    memset(reached, false, mesh->column_count + 1);
+    int component_size =
+        connectedColumns(mesh, getMinColumn(mesh), reached, component);
+
+    int rest_size = 0;
+    for (int bucket = 1; bucket < BUCKET_COUNT; bucket++) {
+        NodeIndex sentinel = BUCKET_SENTINEL(bucket);
+        for (NodeIndex column = mesh->bucket_next[sentinel]; column != sentinel;
+             column           = mesh->bucket_next[column])
+            if (!reached[column]) rest[rest_size++] = column;
+    }
+    if (rest_size == 0) return false;
+
+    SolverContext* part = (SolverContext*)malloc(sizeof(SolverContext));
+    if (part == NULL) return false;
+    STATS_ADD(&mesh->stats, splits, 1);
+    part->propagate = context->propagate;
+    part->decompose = context->decompose;
+    // the keys of the table do not tell the parts from the whole problem
+    part->table     = NULL;
+
+    // the parts only write their rows into the hexadoku while it has no
+    // solution yet, the first solution overwrites anything written in vain
+    uint8_t** hexadoku = context->solution_count == 0 ? context->hexadoku
+                                                      : NULL;
+    int       needed =
+        context->solution_limit == 0
+            ? 0
+            : context->solution_limit - context->solution_count;
+    int component_count =
+        countPart(part, context, mesh, hexadoku, needed, rest, rest_size);
+    int rest_count = 0;
+    if (component_count > 0) {
+        // enough combinations to reach the limit with the component's count
+        int rest_needed = (needed + component_count - 1) / component_count;
+        rest_count      = countPart(part, context, mesh, hexadoku, rest_needed,
+                                    component, component_size);
+    }
+    free(part);
+
+    // the parts complete a grid only together
+    if (rest_count > 0 && context->base_depth == 0)
+        STATS_SOLUTION(&mesh->stats);
+    if (rest_count > 0 && context->solution_count == 0)
+        stackToHexadoku(context, mesh);
+    addSolutions(context, (long long)component_count * rest_count);
+    return true;
 }
 
-void uncover(Node* column_header) {
-    for (Node* v_node = column_header->up; v_node != column_header;
-         v_node       = v_node->up) {
-        for (Node* h_node = v_node->left; h_node != v_node;
-             h_node       = h_node->left) {
-            relinkVertical(h_node);
-            h_node->column_header->nodeCount++;
+// Branch on the most constrained column, or record a solution if all columns
+// are covered.
+static void descend(SolverContext* context, Mesh* mesh) {
+    STATS_VISIT(&mesh->stats, context->base_depth + context->depth);
+    int trail_start = context->trail_size;
+    if (context->propagate) propagateSingles(context, mesh);
+
+    // If there are no more columns, we have found a solution.
+    if (mesh->bucket_mask == 0) {
+        // a nested search has only covered the columns of its part
+        if (context->base_depth == 0) STATS_SOLUTION(&mesh->stats);
+        if (context->solution_count == 0) stackToHexadoku(context, mesh);
+        context->solution_count++;
+        return;
+    }
+
+    // the table is shared by the puzzles of a thread, so a subtree with
+    // solutions is still searched until this puzzle has its first one
+    int solution_count;
+    if (context->table != NULL &&
+        probeTranspositionTable(context->table, context->key,
+                                &solution_count) &&
+        (solution_count == 0 || context->solution_count > 0)) {
+        STATS_ADD(&mesh->stats, table_hits, 1);
+        addSolutions(context, solution_count);
+        return;
+    }
+
+    // a node with an empty column has no solutions to split
+    if (context->decompose && (mesh->bucket_mask & BUCKET_BIT(0)) == 0 &&
+        maxOpenNodes(mesh) <= SPLIT_MAX_NODES && countComponents(context, mesh))
+        return;
+
+    NodeIndex column = getMinColumn(mesh);
+    if (mesh->node_count[column] == 0) STATS_ADD(&mesh->stats, backtracks, 1);
+    cover(mesh, column);
+
+    SearchFrame* frame      = &context->stack[context->depth++];
+    frame->column           = column;
+    frame->row_node         = column;
+    frame->trail_start      = trail_start;
+    frame->trail_end        = context->trail_size;
+    frame->solutions_before = context->solution_count;
+    frame->key              = context->key;
+}
+
+// Undo the row selected at the deepest level and select its next row,
+// dropping levels whose column has no rows left.
+// @return false once the whole tree has been searched.
+static bool advance(SolverContext* context, Mesh* mesh) {
+    Node* nodes = mesh->nodes;
+    bool  limit_reached = isSolutionLimitReached(context->solution_count,
+                                                 context->solution_limit);
+
+    while (context->depth > 0) {
+        SearchFrame* frame    = &context->stack[context->depth - 1];
+        NodeIndex    row_node = frame->row_node;
+
+        // rows forced below the current row of this level
+        undoTrail(context, mesh, frame->trail_end);
+        if (row_node != frame->column) {
+            uncoverRowNeighbors(mesh, row_node);
+            toggleRowKey(context, mesh, row_node);
+        }
+
+        row_node = nodes[row_node].down;
+        if (row_node == frame->column || limit_reached) {
+            if (context->table != NULL && !limit_reached)
+                storeTranspositionTable(
+                    context->table, frame->key,
+                    context->solution_count - frame->solutions_before,
+                    context->depth - 1);
+            uncover(mesh, frame->column);
+            undoTrail(context, mesh, frame->trail_start);
+            context->depth--;
+            continue;
         }
+
+        STATS_BRANCH(&mesh->stats, context->base_depth + context->depth - 1);
+        frame->row_node = row_node;
+        coverRowNeighbors(mesh, row_node);
+        toggleRowKey(context, mesh, row_node);
+        return true;
     }
+    undoTrail(context, mesh, 0);
+    return false;
+}
 
-    relinkHorizontal(column_header);
+void searchSolutions(SolverContext* context, Mesh* mesh) {
+    while (stepSearch(context, mesh)) {
+    }
 }
 
-Node* getMinColumn(Node* head) {
-    Node* min_column    = head->right;
-    Node* column_header = head->right->right;
-    while (column_header != head) {
-        // Node count can't be any lower than 1.
-        if (column_header->nodeCount <= 1) return column_header;
-        if (column_header->nodeCount < min_column->nodeCount)
-            min_column = column_header;
-        column_header = column_header->right;
+bool stepSearch(SolverContext* context, Mesh* mesh) {
+    descend(context, mesh);
+    return advance(context, mesh);
+}
+
+void prefetchSearchStep(const Mesh* mesh) {
+    if (mesh->bucket_mask == 0) return;
+    // the column of a forced row, or the one the next level branches on; the
+    // headers are few and usually cached, the row groups are not
+    int         bucket = __builtin_ctzll(mesh->bucket_mask);
+    NodeIndex   column = mesh->bucket_next[BUCKET_SENTINEL(bucket)];
+    const Node* header = &mesh->nodes[column];
+    __builtin_prefetch(&mesh->nodes[header->down]);
+    __builtin_prefetch(&mesh->nodes[header->up]);
+}
+
+// Move a column to the neighboring bucket after its node count changed.
+static inline void bucketMove(Mesh* mesh, NodeIndex column_header,
+                              int old_size, int new_size) {
+    bucketRemove(mesh, column_header, old_size);
+    bucketInsert(mesh, column_header, new_size);
+}
+
+// Take a node out of its column, which becomes one node shorter.
+static inline void detachNode(Mesh* mesh, NodeIndex node) {
+    NodeIndex column = mesh->nodes[node].column_header;
+    unlinkVertical(mesh->nodes, node);
+    STATS_ADD(&mesh->stats, link_updates, 2);
+    int size = mesh->node_count[column]--;
+    bucketMove(mesh, column, size, size - 1);
+}
+
+// Undo detachNode.
+static inline void reattachNode(Mesh* mesh, NodeIndex node) {
+    NodeIndex column = mesh->nodes[node].column_header;
+    relinkVertical(mesh->nodes, node);
+    STATS_ADD(&mesh->stats, link_updates, 2);
+    int size = mesh->node_count[column]++;
+    bucketMove(mesh, column, size, size + 1);
+}
+
+_Static_assert(CONSTRAINTS == 4, "cover and uncover are unrolled for 4 nodes");
+
+void cover(Mesh* mesh, NodeIndex column_header) {
+    Node* nodes = mesh->nodes;
+    STATS_ADD(&mesh->stats, covers, 1);
+    bucketRemove(mesh, column_header, mesh->node_count[column_header]);
+    mesh->open_columns--;
+
+    for (NodeIndex v_node = nodes[column_header].down; v_node != column_header;
+         v_node           = nodes[v_node].down) {
+        detachNode(mesh, rowNeighbor(v_node, 1));
+        detachNode(mesh, rowNeighbor(v_node, 2));
+        detachNode(mesh, rowNeighbor(v_node, 3));
     }
-    return min_column;
 }
 
-inline void unlinkHorizontal(Node* node) {
-    node->left->right = node->right;
-    node->right->left = node->left;
+void uncover(Mesh* mesh, NodeIndex column_header) {
+    Node* nodes = mesh->nodes;
+    STATS_ADD(&mesh->stats, uncovers, 1);
+    for (NodeIndex v_node = nodes[column_header].up; v_node != column_header;
+         v_node           = nodes[v_node].up) {
+        reattachNode(mesh, rowNeighbor(v_node, 3));
+        reattachNode(mesh, rowNeighbor(v_node, 2));
+        reattachNode(mesh, rowNeighbor(v_node, 1));
+    }
+
+    bucketInsert(mesh, column_header, mesh->node_count[column_header]);
+    mesh->open_columns++;
+}
+
+void coverRowNeighbors(Mesh* mesh, NodeIndex row_node) {
+    Node* nodes = mesh->nodes;
+    cover(mesh, nodes[rowNeighbor(row_node, 1)].column_header);
+    cover(mesh, nodes[rowNeighbor(row_node, 2)].column_header);
+    cover(mesh, nodes[rowNeighbor(row_node, 3)].column_header);
+}
+
+void uncoverRowNeighbors(Mesh* mesh, NodeIndex row_node) {
+    Node* nodes = mesh->nodes;
+    uncover(mesh, nodes[rowNeighbor(row_node, 3)].column_header);
+    uncover(mesh, nodes[rowNeighbor(row_node, 2)].column_header);
+    uncover(mesh, nodes[rowNeighbor(row_node, 1)].column_header);
+}
+
+NodeIndex getMinColumn(Mesh* mesh) {
+    int bucket = __builtin_ctzll(mesh->bucket_mask);
+    return mesh->bucket_next[BUCKET_SENTINEL(bucket)];
+}
+
+inline void bucketInsert(Mesh* mesh, NodeIndex column_header, int size) {
+    NodeIndex sentinel = BUCKET_SENTINEL(BUCKET_OF(size));
+    NodeIndex next     = mesh->bucket_next[sentinel];
+    mesh->bucket_next[column_header] = next;
+    mesh->bucket_prev[column_header] = sentinel;
+    mesh->bucket_prev[next]          = column_header;
+    mesh->bucket_next[sentinel]      = column_header;
+    mesh->bucket_mask |= BUCKET_BIT(BUCKET_OF(size));
 }
 
-inline void relinkHorizontal(Node* node) {
-    node->left->right = node;
-    node->right->left = node;
+inline void bucketRemove(Mesh* mesh, NodeIndex column_header, int size) {
+    NodeIndex prev = mesh->bucket_prev[column_header];
+    NodeIndex next = mesh->bucket_next[column_header];
+    mesh->bucket_next[prev] = next;
+    mesh->bucket_prev[next] = prev;
+    // the bucket is empty once its sentinel links to itself
+    if (prev == next) mesh->bucket_mask &= ~BUCKET_BIT(BUCKET_OF(size));
 }
 
-inline void unlinkVertical(Node* node) {
-    node->up->down = node->down;
-    node->down->up = node->up;
+inline void unlinkVertical(Node* nodes, NodeIndex node) {
+    nodes[nodes[node].up].down = nodes[node].down;
+    nodes[nodes[node].down].up = nodes[node].up;
 }
 
-inline void relinkVertical(Node* node) {
-    node->up->down = node;
-    node->down->up = node;
+inline void relinkVertical(Node* nodes, NodeIndex node) {
+    nodes[nodes[node].up].down = node;
+    nodes[nodes[node].down].up = node;
 }
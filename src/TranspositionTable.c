@@ -0,0 +1,107 @@
+#include "TranspositionTable.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Constants.h"
+#include "Coords.h"
+
+#define ROWS (COORDS_COUNT / CONSTRAINTS)
+
+static uint64_t       row_keys[ROWS];
+static pthread_once_t row_keys_once = PTHREAD_ONCE_INIT;
+
+// splitmix64, a fixed sequence so that runs are reproducible.
+static uint64_t mixKey(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static void initRowKeys(void) {
+    for (int row = 0; row < ROWS; row++) {
+        int constraints[CONSTRAINTS];
+        rowConstraints(row, constraints);
+        for (int i = 0; i < CONSTRAINTS; i++)
+            row_keys[row] ^= mixKey(constraints[i]);
+    }
+}
+
+uint64_t rowKey(int row) { return row_keys[row]; }
+
+TranspositionTable* createTranspositionTable(size_t megabytes) {
+    pthread_once(&row_keys_once, initRowKeys);
+
+    size_t bytes   = megabytes << 20;
+    size_t buckets = 1;
+    while (2 * buckets * TABLE_BUCKET_SIZE * sizeof(TableEntry) <= bytes)
+        buckets *= 2;
+    if (buckets * TABLE_BUCKET_SIZE * sizeof(TableEntry) > bytes) return NULL;
+
+    TranspositionTable* table =
+        (TranspositionTable*)malloc(sizeof(TranspositionTable));
+    if (table == NULL) return NULL;
+    table->entries =
+        (TableEntry*)calloc(buckets * TABLE_BUCKET_SIZE, sizeof(TableEntry));
+    if (table->entries == NULL) {
+        free(table);
+        return NULL;
+    }
+    table->bucket_mask = buckets - 1;
+    table->generation  = 1;
+    return table;
+}
+
+void freeTranspositionTable(TranspositionTable* table) {
+    if (table == NULL) return;
+    free(table->entries);
+    free(table);
+}
+
+void clearTranspositionTable(TranspositionTable* table) {
+    if (++table->generation != 0) return;
+    memset(table->entries, 0,
+           (table->bucket_mask + 1) * TABLE_BUCKET_SIZE * sizeof(TableEntry));
+    table->generation = 1;
+}
+
+static inline TableEntry* bucketOf(const TranspositionTable* table,
+                                   uint64_t key) {
+    return &table->entries[(key & table->bucket_mask) * TABLE_BUCKET_SIZE];
+}
+
+bool probeTranspositionTable(const TranspositionTable* table, uint64_t key,
+                             int* solution_count) {
+    const TableEntry* bucket = bucketOf(table, key);
+    for (int i = 0; i < TABLE_BUCKET_SIZE; i++) {
+        if (bucket[i].key == key && bucket[i].generation == table->generation) {
+            *solution_count = bucket[i].solution_count;
+            return true;
+        }
+    }
+    return false;
+}
+
+void storeTranspositionTable(TranspositionTable* table, uint64_t key,
+                             int solution_count, int depth) {
+    TableEntry* bucket = bucketOf(table, key);
+    TableEntry* victim = &bucket[0];
+    bool        open   = false;
+    for (int i = 0; i < TABLE_BUCKET_SIZE; i++) {
+        if (bucket[i].generation != table->generation ||
+            bucket[i].key == key) {
+            victim = &bucket[i];
+            open   = true;
+            break;
+        }
+        if (bucket[i].depth > victim->depth) victim = &bucket[i];
+    }
+    if (!open && victim->depth < depth) return;
+
+    victim->key            = key;
+    victim->solution_count = solution_count;
+    victim->depth          = (uint16_t)depth;
+    victim->generation     = table->generation;
+}
@@ -2,6 +2,23 @@
 
 PROGRAMS=("./bin/main_dev.out" "./bin/main_release.out")
 TESTS_DIRS=("data/basic" "data/extra")
+BATCH_TESTS_DIRS=("data/batch")
+LIMIT_TESTS_DIRS=("data/limit")
+PARALLEL_TESTS_DIRS=("data/parallel")
+LINE_TESTS_DIRS=("data/line")
+LINE_BATCH_TESTS_DIRS=("data/line_batch")
+EMPTY_TESTS_DIRS=()
+
+# Builds for other grid sizes (`make BOX_SIZE=N test`) have their own puzzles
+if [[ -n ${BOX_SIZE} && ${BOX_SIZE} != 4 ]]; then
+	TESTS_DIRS=("data/order${BOX_SIZE}")
+	BATCH_TESTS_DIRS=()
+	LIMIT_TESTS_DIRS=()
+	PARALLEL_TESTS_DIRS=()
+	LINE_TESTS_DIRS=()
+	LINE_BATCH_TESTS_DIRS=()
+	EMPTY_TESTS_DIRS=("data/order${BOX_SIZE}/empty")
+fi
 
 clean_up() {
 	rm -f time.txt test_out.txt
@@ -10,11 +27,12 @@ clean_up() {
 run_tests() {
 	local program="$1"
 	local tests_dir="$2"
-	echo "Testing ${program} in directory ${tests_dir}"
+	shift 2
+	echo "Testing ${program} $* in directory ${tests_dir}"
 
 	for IN_FILE in "${tests_dir}"/*_in.txt; do
 		REF_FILE="${IN_FILE/_in.txt/_out.txt}"
-		{ time "${program}" <"${IN_FILE}" >test_out.txt; } 2>time.txt
+		{ time "${program}" "$@" <"${IN_FILE}" >test_out.txt; } 2>time.txt
 		if ! diff "${REF_FILE}" test_out.txt >/dev/null; then
 			echo "Test FAILED: ${IN_FILE}"
 			echo "Reference file: ${REF_FILE}"
@@ -46,6 +64,103 @@ for prog in "${programs_to_test[@]}"; do
 	for tests_dir in "${TESTS_DIRS[@]}"; do
 		run_tests "${prog}" "${tests_dir}"
 		echo ''
+		run_tests "${prog}" "${tests_dir}" -j 4
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -t 16
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -j 4 -t 16
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -C
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -e bitset
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -e bitcover
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -e lockstep
+		echo ''
+	done
+	for tests_dir in "${BATCH_TESTS_DIRS[@]}"; do
+		run_tests "${prog}" "${tests_dir}" -b
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -b -j 4
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -b -j 2 -i 4
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -b -t 16
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -b -j 2 -i 4 -t 16
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -b -e bitset
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -b -e bitcover
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -b -e lockstep
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -b -S
+		echo ''
+	done
+	for tests_dir in "${LIMIT_TESTS_DIRS[@]}"; do
+		run_tests "${prog}" "${tests_dir}" -k 2
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -k 2 -j 4
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -k 2 -e bitset
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -k 2 -e bitcover
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -k 2 -e lockstep
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -k 2 -S
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -k 2 -t 16
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -k 2 -C
+		echo ''
+	done
+	# puzzles with many solutions, whose subtrees are counted by several
+	# workers that share nothing but must add up to the serial count
+	for tests_dir in "${PARALLEL_TESTS_DIRS[@]}"; do
+		run_tests "${prog}" "${tests_dir}" -j 2 -t 1
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -j 4 -t 1
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -j 8 -t 1
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -j 4 -t 16
+		echo ''
+	done
+	# an empty grid, whose search is the deepest the grid size allows; DLX
+	# branches too long on it from 49x49 on and bitcover from 64x64 on
+	for tests_dir in "${EMPTY_TESTS_DIRS[@]}"; do
+		if ((BOX_SIZE < 7)); then
+			run_tests "${prog}" "${tests_dir}" -k 2
+			echo ''
+		fi
+		run_tests "${prog}" "${tests_dir}" -k 2 -e bitset
+		echo ''
+		if ((BOX_SIZE < 8)); then
+			run_tests "${prog}" "${tests_dir}" -k 2 -e bitcover
+			echo ''
+		fi
+		run_tests "${prog}" "${tests_dir}" -k 2 -e lockstep
+		echo ''
+	done
+	# one puzzle per file, so batch mode prints the same
+	for tests_dir in "${LINE_TESTS_DIRS[@]}"; do
+		run_tests "${prog}" "${tests_dir}" -f line
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -f line -e bitset
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -f line -b
+		echo ''
+	done
+	for tests_dir in "${LINE_BATCH_TESTS_DIRS[@]}"; do
+		run_tests "${prog}" "${tests_dir}" -f line -b
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -f line -b -j 4
+		echo ''
+		run_tests "${prog}" "${tests_dir}" -f line -b -e lockstep
+		echo ''
 	done
 done
 